@@ -22,14 +22,16 @@ This file contains the sources for the audio source.
 
 #include "AudioSource.h"
 
-#include <cmath>
-#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
-#include <ctime>
-#include <iostream>
-#include <fstream>
 
-#include "NoisePwrSpectrum.h"
+#include "RealTime.h"
+
+
+const size_t AudioSource::RENDER_BLOCK_SIZE;
+const int AudioSource::RENDER_IDLE_MS;
+const size_t AudioSource::CACHE_COPY_SIZE;
 
 
 //!************************************************************************
@@ -42,884 +44,773 @@ AudioSource::AudioSource
     )
     : mAudioFormat( aFormat )
     , mAudioBufferLengthSeconds( aBufferLengthSeconds )
-    , mBufferPos( 0 )
+    , mRequestedBufferLengthSeconds( aBufferLengthSeconds )
+    , mRenderEngine( aFormat.sampleRate(), 0 )
+    , mRingBuffer( RING_BUFFER_SIZE )
+    , mRenderRunning( false )
+    , mRenderData( RENDER_BLOCK_SIZE )
+    , mRenderSamples( RENDER_BLOCK_SIZE )
+    , mStartPosition( 0 )
+    , mSkipSamples( 0 )
+    , mRenderedPosition( 0 )
+    , mItemsHash( 0 )
+    , mLiveEdited( false )
+    , mCachedLength( 0 )
+    , mPlayingCache( false )
+    , mCachePosition( 0 )
+    , mRecordPosition( 0 )
+    , mCopyPosition( 0 )
+    , mPendingData( nullptr )
+    , mRetiredData( nullptr )
+    , mRealTimeEnabled( false )
+    , mRealTimeGuarantees( 0 )
 {
-    srand( time( NULL ) );
+    mRenderEngine.reserve( RENDER_BLOCK_SIZE );
 }
 
 
 //!************************************************************************
-//! Get the number of bytes that are available for reading
-//! see QIODevice::bytesAvailable()
-//!
-//! @returns: Number of available bytes
+//! Destructor
 //!************************************************************************
-qint64 AudioSource::bytesAvailable() const
+AudioSource::~AudioSource()
 {
-    return mAudioBuffer.size() + QIODevice::bytesAvailable();
+    stopRenderThread();
+
+    deleteLiveData( mPendingData.exchange( nullptr ) );
+    deleteLiveData( mRetiredData.exchange( nullptr ) );
 }
 
 
 //!************************************************************************
-//! Fill the audio buffer with generated data
+//! Copy the next samples of the cache entry being extended to the
+//! recorder, at most CACHE_COPY_SIZE of them
+//! Called by the render thread when the ring is full, so the entry is
+//! copied in its idle time instead of on the GUI thread.
 //!
-//! @returns: nothing
+//! @returns: true if samples were copied
 //!************************************************************************
-void AudioSource::fillDataBuffer()
+bool AudioSource::copyCachedSamples()
 {
-    const int SAMPLE_BYTES = mAudioFormat.sampleSize() / 8;                         // = 2
-    const int CHANNEL_BYTES = mAudioFormat.channelCount() * SAMPLE_BYTES;           // = 2
+    const bool isCopying = mCacheRecorder.is_open() && mCopyPosition < mCachedLength;
 
-    qint64 bufferLength = mAudioFormat.sampleRate() * mAudioBufferLengthSeconds;    // = 44100 * DURATION_SECONDS
-    std::vector<double> totalNoiseBuffer( bufferLength );
-
-    for( size_t k = 0; k < mSignalsVector.size(); k++ )
+    if( isCopying )
     {
-        if( SignalItem::SIGNAL_TYPE_NOISE == mSignalsVector.at( k )->getType() )
-        {
-            std::vector<double> crtNoiseBuffer( bufferLength );
-
-            for( size_t i = 0; i < bufferLength; i++ )
-            {
-                double time = static_cast<double>( i % mAudioFormat.sampleRate() ) / mAudioFormat.sampleRate();
-                time += static_cast<size_t>( i / mAudioFormat.sampleRate() );
-                crtNoiseBuffer.at( i ) = getSignalValueNoise( mSignalsVector.at( k )->getSignalDataNoise(), time );
-            }
-
-            SignalItem::SignalNoise sig = mSignalsVector.at( k )->getSignalDataNoise();
-
-            if( 0 == sig.gamma ) // white noise
-            {
-                for( size_t i = 0; i < bufferLength; i++ )
-                {
-                    totalNoiseBuffer.at( i ) += crtNoiseBuffer.at( i );
-                }
-            }
-            else // any value in [-2..2] except 0
-            {
-                NoisePwrSpectrum noisePwrSpectrum( sig.gamma );
-                std::vector<double> filteredNoiseBuffer( bufferLength );
-                noisePwrSpectrum.filterData( crtNoiseBuffer, filteredNoiseBuffer );
-
-                for( size_t i = 0; i < bufferLength; i++ )
-                {
-                    totalNoiseBuffer.at( i ) += filteredNoiseBuffer.at( i );
-                }
-            }
-        }
-    }
-
-    bufferLength = mAudioFormat.sampleRate() * CHANNEL_BYTES * mAudioBufferLengthSeconds; // = 44100 * 2 * DURATION_SECONDS
-
-    mAudioBuffer.resize( bufferLength );
-    unsigned char* bufferData = reinterpret_cast<unsigned char *>( mAudioBuffer.data() );
+        const size_t count = static_cast<size_t>( std::min<uint64_t>( CACHE_COPY_SIZE, mCachedLength - mCopyPosition ) );
+        const int16_t* cachedSamples = reinterpret_cast<const int16_t*>( mCachedLoop->getData() );
 
-    const bool SAVE_TO_RAW_FILE = false;
-    std::ofstream outputFile;
-
-    if( SAVE_TO_RAW_FILE )
-    {
-        outputFile.open( "out_raw.txt" );
+        mCacheRecorder.write( reinterpret_cast<const char*>( cachedSamples + mCopyPosition ), count * sizeof( int16_t ) );
+        mCopyPosition += count;
     }
 
-    for( size_t i = 0; bufferLength > 0; bufferLength -= SAMPLE_BYTES, i++ )
-    {
-        double time = static_cast<double>( i % mAudioFormat.sampleRate() ) / mAudioFormat.sampleRate();
-        time += static_cast<size_t>( i / mAudioFormat.sampleRate() );
-        double yGenerated = getSignalValue( time );
-        yGenerated += totalNoiseBuffer.at( i );
-
-        if( SAVE_TO_RAW_FILE && outputFile.is_open() )
-        {
-            QString line = QString::number( time ) + "\t" + QString::number( yGenerated ) + "\n";
-            outputFile << line.toStdString();
-        }
+    return isCopying;
+}
 
-        int16_t yValue = static_cast<int16_t>( yGenerated * 32767 );
-        memcpy( bufferData, &yValue, sizeof( yValue ) );
-        bufferData += SAMPLE_BYTES;
-    }
 
-    if( SAVE_TO_RAW_FILE && outputFile.is_open() )
+//!************************************************************************
+//! Delete a list of live updates
+//!
+//! @returns: nothing
+//!************************************************************************
+void AudioSource::deleteLiveData
+    (
+    LiveData*       aLiveData       //!< first entry of a list, may be null
+    )
+{
+    while( aLiveData )
     {
-        outputFile.close();
+        LiveData* nextData = aLiveData->next;
+        delete aLiveData;
+        aLiveData = nextData;
     }
 }
 
 
 //!************************************************************************
-//! Generate a random number
-//! adapted from Knuth, D.E. - The Art of Computer Programming
-//!                            Volume 2, Seminumerical Algorithms
-//!                            3rd Ed, Addison-Wesley, 1997
+//! Get the number of bytes that are available for reading
+//! see QIODevice::bytesAvailable()
 //!
-//! @returns: a random double in [0..1]
+//! readData() always delivers the requested length, padding an underrun
+//! of the ring with silence, so the whole ring is reported.
+//!
+//! @returns: Number of available bytes
 //!************************************************************************
-double AudioSource::generateRandomDek
-    (
-    int32_t*   pIdum        //!< seed value
-    ) const
+qint64 AudioSource::bytesAvailable() const
 {
-    const int32_t MBIG = 1000000000;
-    const int32_t MSEED = 161803398;
-    const int32_t MZ = 0;
-    const double FAC = 1.0 / MBIG;
-
-    static int32_t inext;
-    static int32_t inextp;
-    static int32_t ma[56];
-    static int32_t iff = 0;
-    int32_t mj;
-    int32_t mk;
-    int32_t i;
-    int32_t ii;
-    int32_t k;
-
-    if( *pIdum < 0 || iff == 0 )
-    {
-        iff = 1;
-        mj = labs( MSEED - labs( *pIdum ) );
-        mj %= MBIG;
-        ma[55] = mj;
-        mk = 1;
+    return static_cast<qint64>( mRingBuffer.getCapacity() * sizeof( int16_t ) ) + QIODevice::bytesAvailable();
+}
 
-        for( i = 1; i <= 54; i++ )
-        {
-            ii = ( 21 * i ) % 55;
-            ma[ii] = mk;
-            mk = mj - mk;
 
-            if( mk < MZ )
-            {
-                mk += MBIG;
-            }
+//!************************************************************************
+//! Look up the cache entry of the signal
+//! Only the part of the entry within the audio buffer length is used.
+//!
+//! @returns: nothing
+//!************************************************************************
+void AudioSource::findCachedLoop()
+{
+    mCachedLoop.reset();
+    mCachedLength = 0;
 
-            mj = ma[ii];
-        }
+    if( mRenderCache && !mLiveEdited && !mRealTimeEnabled )
+    {
+        mCachedLoop = mRenderCache->find( mCacheKey );
 
-        for( k = 1; k <= 4; k++ )
+        if( mCachedLoop )
         {
-            for( i = 1; i <= 55; i++ )
-            {
-                ma[i] -= ma[ 1 + ( i + 30 ) % 55 ];
-
-                if( ma[i] < MZ )
-                {
-                    ma[i] += MBIG;
-                }
-            }
+            mCachedLength = std::min<uint64_t>( mCachedLoop->getSize() / sizeof( int16_t ), getLoopLength() );
         }
-
-        inext = 0;
-        inextp = 31;
-        *pIdum = 1;
-    }
-
-    if( ++inext == 56 )
-    {
-        inext = 1;
-    }
-
-    if( ++inextp == 56 )
-    {
-        inextp = 1;
     }
+}
 
-    mj = ma[inext] - ma[inextp];
 
-    if( mj < MZ )
-    {
-        mj += MBIG;
-    }
+//!************************************************************************
+//! Get the audio format
+//!
+//! @returns: audio format of the rendered samples
+//!************************************************************************
+const QAudioFormat& AudioSource::getFormat() const
+{
+    return mAudioFormat;
+}
 
-    ma[inext] = mj;
 
-    return ( double )( mj * FAC );
+//!************************************************************************
+//! Get the length after which the signal repeats
+//!
+//! @returns: loop length [samples]
+//!************************************************************************
+uint64_t AudioSource::getLoopLength() const
+{
+    return static_cast<uint64_t>( mAudioFormat.sampleRate() ) * mAudioBufferLengthSeconds;
 }
 
 
 //!************************************************************************
-//! Generate a random number
-//! adapted from Press, W.H. et al - Numerical Recipes in C. The Art of Scientific Computing
-//!                                  2nd Ed, Cambridge Univ. Press, 1992
+//! Get the index of the next sample delivered to the audio output
+//! Samples still buffered by the audio device are not accounted for.
 //!
-//! see ran4(), subchapter 7.5, pp. 303
-//!
-//! @returns: a random double in [0..1]
+//! @returns: sample index, in [0, loop length)
 //!************************************************************************
-double AudioSource::generateRandomNag
-    (
-    int32_t*   pIdum        //!< seed value
-    ) const
+uint64_t AudioSource::getPosition() const
 {
-    const uint32_t JFLONE = 0x3f800000;
-    const uint32_t JFLMSK = 0x007fffff;
-    static int32_t idums = 0;
+    const uint64_t loopLength = getLoopLength();
+    uint64_t position = 0;
 
-    if( *pIdum < 0 )
+    if( loopLength )
     {
-        idums = -( *pIdum );
-        *pIdum = 1;
+        const uint64_t buffered = mRingBuffer.getFillLevel() % loopLength;
+        position = ( mRenderedPosition.load() % loopLength + loopLength - buffered ) % loopLength;
     }
 
-    uint32_t irword = *pIdum;
-    uint32_t lword = idums;
-    pseudoDes( &lword, &irword );
-    uint32_t itemp = JFLONE | ( JFLMSK & irword );
-    ++( *pIdum );
-
-    return ( *reinterpret_cast< float* >( &itemp ) - 1.0 );
+    return position;
 }
 
 
 //!************************************************************************
-//! Get the value of the entire signal, obtained by superposition
-//! through the entire vector *without noise*
+//! Get the real-time guarantees obtained for the render thread
 //!
-//! @returns The value of the signal at a specified moment
+//! @returns: RealTime::Guarantee flags, 0 when stopped or not requested
 //!************************************************************************
-double AudioSource::getSignalValue
-    (
-    const double aTime      //!< time
-    ) const
+unsigned AudioSource::getRealTimeGuarantees() const
 {
-    double y = 0;
-
-    for( size_t i = 0; i < mSignalsVector.size(); i++ )
-    {
-        switch( mSignalsVector.at( i )->getType() )
-        {
-            case SignalItem::SIGNAL_TYPE_TRIANGLE:
-                y += getSignalValueTriangle( mSignalsVector.at( i )->getSignalDataTriangle(), aTime );
-                break;
-
-            case SignalItem::SIGNAL_TYPE_RECTANGLE:
-                y += getSignalValueRectangle( mSignalsVector.at( i )->getSignalDataRectangle(), aTime );
-                break;
-
-            case SignalItem::SIGNAL_TYPE_PULSE:
-                y += getSignalValuePulse( mSignalsVector.at( i )->getSignalDataPulse(), aTime );
-                break;
-
-            case SignalItem::SIGNAL_TYPE_RISEFALL:
-                y += getSignalValueRiseFall( mSignalsVector.at( i )->getSignalDataRiseFall(), aTime );
-                break;
+    return mRealTimeGuarantees;
+}
 
-            case SignalItem::SIGNAL_TYPE_SINDAMP:
-                y += getSignalValueSinDamp( mSignalsVector.at( i )->getSignalDataSinDamp(), aTime );
-                break;
 
-            case SignalItem::SIGNAL_TYPE_SINRISE:
-                y += getSignalValueSinRise( mSignalsVector.at( i )->getSignalDataSinRise(), aTime );
-                break;
+//!************************************************************************
+//! Get the time and bytes of each render stage since the source was
+//! started, as last published by the render thread
+//!
+//! @returns: statistics since the source was started
+//!************************************************************************
+RenderStats AudioSource::getRenderStats() const
+{
+    std::lock_guard<std::mutex> lock( mStatsMutex );
 
-            case SignalItem::SIGNAL_TYPE_WAVSIN:
-                y += getSignalValueWavSin( mSignalsVector.at( i )->getSignalDataWavSin(), aTime );
-                break;
+    return mPublishedStats;
+}
 
-            case SignalItem::SIGNAL_TYPE_AMSIN:
-                y += getSignalValueAmSin( mSignalsVector.at( i )->getSignalDataAmSin(), aTime );
-                break;
 
-            case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
-                y += getSignalValueSinDampSin( mSignalsVector.at( i )->getSignalDataSinDampSin(), aTime );
-                break;
+//!************************************************************************
+//! Get the fill level statistics of the ring buffer
+//!
+//! @returns: statistics since the source was started
+//!************************************************************************
+AudioSource::RingStats AudioSource::getRingStats() const
+{
+    RingStats stats;
+    stats.capacity = mRingBuffer.getCapacity();
+    stats.fillLevel = mRingBuffer.getFillLevel();
+    stats.minFillLevel = mRingBuffer.getMinFillLevel();
+    stats.nrOfUnderruns = mRingBuffer.getNrOfUnderruns();
 
-            case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
-                y += getSignalValueTrapDampSin( mSignalsVector.at( i )->getSignalDataTrapDampSin(), aTime );
-                break;
+    return stats;
+}
 
-            case SignalItem::SIGNAL_TYPE_NOISE: // intentionally skip noise type
-            default:
-                break;
-        }
-    }
 
-    return y;
+//!************************************************************************
+//! Check if the audio source is started
+//!
+//! @returns: If the device is open
+//!************************************************************************
+bool AudioSource::isStarted() const
+{
+    return isOpen();
 }
 
 
 //!************************************************************************
-//! Get the value of a Triangle signal
+//! Reads up to aLength bytes from the device into aData
+//! see QIODevice::readData()
+//!
+//! Only copies from the ring buffer. If the render thread fell behind,
+//! the missing samples are replaced by silence and counted as underrun.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: Number of bytes read
 //!************************************************************************
-double AudioSource::getSignalValueTriangle
+qint64 AudioSource::readData
     (
-    const SignalItem::SignalTriangle    aSignalData,    //!< Triangle signal data
-    const double                        aTime           //!< time
-    ) const
+    char*   aData,          //!< data content
+    qint64  aLength         //!< data length
+    )
 {
-    double y = 0;
+    const size_t nrOfSamples = static_cast<size_t>( aLength ) / sizeof( int16_t );
+    int16_t* samples = reinterpret_cast<int16_t*>( aData );
 
-    if( aTime >= aSignalData.tDelay )
-    {
-        double dt0 = aTime - aSignalData.tDelay;
-        uint32_t kPer = dt0 / aSignalData.tPeriod;
-        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+    const size_t nrOfRead = mRingBuffer.read( samples, nrOfSamples );
+    memset( samples + nrOfRead, 0, ( nrOfSamples - nrOfRead ) * sizeof( int16_t ) );
 
-        if( tInPer <= aSignalData.tRise )
-        {
-            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
-        }
-        else
-        {
-            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise ) / aSignalData.tFall;
-        }
-    }
-
-    return y;
+    return static_cast<qint64>( nrOfSamples * sizeof( int16_t ) );
 }
 
 
 //!************************************************************************
-//! Get the value of a Rectangle signal
+//! Render the next block of the signal into the ring buffer
+//!
+//! Blocks are multiples of RenderEngine::CHUNK_ALIGNMENT, except the last
+//! one of each audio buffer length, after which the engine is rewound.
+//! Parameters published by setLiveData() are applied first; they end the
+//! use of the render cache until the next setData().
+//! While the position is within a cache entry, its samples are copied
+//! instead; past its end, the rest is rendered and recorded.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: true if a block was rendered, false if the ring is too full
 //!************************************************************************
-double AudioSource::getSignalValueRectangle
-    (
-    const SignalItem::SignalRectangle   aSignalData,    //!< Rectangle signal data
-    const double                        aTime           //!< time
-    ) const
+bool AudioSource::renderBlock()
 {
-    double y = 0;
+    LiveData* liveData = mPendingData.exchange( nullptr );
 
-    if( aTime >= aSignalData.tDelay )
+    if( liveData )
     {
-        double dt0 = aTime - aSignalData.tDelay;
-        uint32_t kPer = dt0 / aSignalData.tPeriod;
-        double tInPer = dt0 - kPer * aSignalData.tPeriod;
-
-        if( tInPer <= aSignalData.tPeriod * aSignalData.fillFactor )
+        if( mPlayingCache )
         {
-            y = aSignalData.yMax;
+            renderFrom( mCachePosition );
         }
-        else
+
+        stopCacheRecording( false );
+        mCachedLoop.reset();
+        mCachedLength = 0;
+        mLiveEdited = true;
+
+        mRenderEngine.applyUpdate( liveData->update );
+
+        // hand the data faded out before back to the GUI thread, which frees it
+        liveData->next = mRetiredData.load();
+
+        while( !mRetiredData.compare_exchange_weak( liveData->next, liveData ) )
         {
-            y = aSignalData.yMin;
         }
     }
 
-    return y;
-}
-
-
-//!************************************************************************
-//! Get the value of a Pulse signal
-//!
-//! @returns The signal value at a specified moment
-//!************************************************************************
-double AudioSource::getSignalValuePulse
-    (
-    const SignalItem::SignalPulse       aSignalData,    //!< Pulse signal data
-    const double                        aTime           //!< time
-    ) const
-{
-    double y = 0;
+    const uint64_t loopLength = getLoopLength();
 
-    if( aTime >= aSignalData.tDelay )
+    if( mPlayingCache )
     {
-        double dt0 = aTime - aSignalData.tDelay;
-        uint32_t kPer = dt0 / aSignalData.tPeriod;
-        double tInPer = dt0 - kPer * aSignalData.tPeriod;
-
-        if( tInPer <= aSignalData.tRise )
+        if( mCachePosition >= loopLength )
         {
-            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
+            mCachePosition = 0;
         }
-        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth )
+
+        if( mCachePosition >= mCachedLength )
         {
-            y = aSignalData.yMax;
+            // end of a shorter entry, render the rest
+            renderFrom( mCachePosition );
         }
-        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall )
+    }
+    else if( mRenderEngine.getPosition() >= loopLength )
+    {
+        stopCacheRecording( mRecordPosition >= loopLength );
+        findCachedLoop();
+
+        if( mCachedLength )
         {
-            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
+            mPlayingCache = true;
+            mCachePosition = 0;
         }
         else
         {
-            y = aSignalData.yMin;
+            mRenderEngine.reset();
+            mSkipSamples = 0;
+            startCacheRecording( false );
         }
     }
 
-    return y;
-}
+    bool hasRoom = false;
 
-
-//!************************************************************************
-//! Get the value of an exponential RiseFall signal
-//!
-//! @returns The signal value at a specified moment
-//!************************************************************************
-double AudioSource::getSignalValueRiseFall
-    (
-    const SignalItem::SignalRiseFall    aSignalData,    //!< RiseFall signal data
-    const double                        aTime           //!< time
-    ) const
-{
-    double y = 0;
-
-    if( aTime >= aSignalData.tDelay )
+    if( mPlayingCache )
     {
-        if( aTime <= aSignalData.tDelayRise )
-        {
-            y = aSignalData.yMin;
-        }
-        else if( aTime > aSignalData.tDelayRise
-              && aTime <= aSignalData.tDelayFall
-               )
-        {
-            y = aSignalData.yMin
-                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) );
+        const size_t count = static_cast<size_t>( std::min<uint64_t>( RENDER_BLOCK_SIZE, mCachedLength - mCachePosition ) );
+        hasRoom = ( count > 0 ) && ( mRingBuffer.getFreeSpace() >= count );
 
-        }
-        else if( aTime > aSignalData.tDelayFall )
+        if( hasRoom )
         {
-            y = aSignalData.yMin
-                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) )
-                + ( aSignalData.yMin - aSignalData.yMax ) * ( 1. - exp( -( aTime - aSignalData.tDelayFall ) / aSignalData.tRampFall ) );
+            const RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+            const int16_t* cachedSamples = reinterpret_cast<const int16_t*>( mCachedLoop->getData() );
+            mRingBuffer.write( cachedSamples + mCachePosition, count );
+            mStats.add( RenderStats::STAGE_COPY, RenderStats::getNanosecondsSince( t0 ), count * sizeof( int16_t ) );
+
+            mCachePosition += count;
+            mRenderedPosition = mCachePosition;
         }
     }
+    else
+    {
+        const uint64_t firstSample = mRenderEngine.getPosition() + mSkipSamples;
+        const size_t count = static_cast<size_t>( std::min<uint64_t>( RENDER_BLOCK_SIZE, loopLength - mRenderEngine.getPosition() ) );
+        hasRoom = ( count > 0 ) && ( mRingBuffer.getFreeSpace() >= count );
 
-    return y;
-}
+        if( hasRoom )
+        {
+            mRenderEngine.render( mRenderData.data(), count );
+            mStats.add( mRenderEngine.getStats() );
+            mRenderEngine.resetStats();
 
+            RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+            RenderEngine::quantize( mRenderData.data(), mRenderSamples.data(), count );
+            mStats.add( RenderStats::STAGE_QUANTIZATION, RenderStats::getNanosecondsSince( t0 ), count * sizeof( int16_t ) );
 
-//!************************************************************************
-//! Get the value of a SinDamp signal
-//!
-//! @returns The signal value at a specified moment
-//!************************************************************************
-double AudioSource::getSignalValueSinDamp
-    (
-    const SignalItem::SignalSinDamp     aSignalData,    //!< SinDamp signal data
-    const double                        aTime           //!< time
-    ) const
-{
-    double y = 0;
+            t0 = RenderStats::Clock::now();
+            mRingBuffer.write( mRenderSamples.data() + mSkipSamples, count - mSkipSamples );
 
-    if( aTime >= aSignalData.tDelay )
-    {
-        double dt0 = aTime - aSignalData.tDelay;
+            if( mCacheRecorder.is_open() )
+            {
+                // the rendered samples follow the whole entry
+                if( firstSample == mRecordPosition && mCopyPosition >= mCachedLength )
+                {
+                    mCacheRecorder.write( reinterpret_cast<const char*>( mRenderSamples.data() + mSkipSamples ), ( count - mSkipSamples ) * sizeof( int16_t ) );
+                    mRecordPosition += count - mSkipSamples;
+                }
+                else
+                {
+                    stopCacheRecording( false );
+                }
+            }
 
-        y = aSignalData.offset
-            + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dt0 + aSignalData.phiRad ) * exp( -aSignalData.damping * dt0 );
+            mStats.add( RenderStats::STAGE_COPY, RenderStats::getNanosecondsSince( t0 ), ( count - mSkipSamples ) * sizeof( int16_t ) );
+            mSkipSamples = 0;
+            mRenderedPosition = mRenderEngine.getPosition();
+        }
+    }
+
+    if( hasRoom && mStatsMutex.try_lock() )
+    {
+        // never wait for the GUI, the next block publishes instead
+        mPublishedStats = mStats;
+        mStatsMutex.unlock();
     }
 
-    return y;
+    return hasRoom;
 }
 
 
 //!************************************************************************
-//! Get the value of a SinRise signal
+//! Continue by rendering, from a sample index
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueSinRise
+void AudioSource::renderFrom
     (
-    const SignalItem::SignalSinRise     aSignalData,    //!< SinRise signal data
-    const double                        aTime           //!< time
-    ) const
+    const uint64_t  aPosition       //!< sample index
+    )
 {
-    double y = 0;
-
-    if( aTime >= aSignalData.tDelay )
-    {
-        if( aTime < aSignalData.tEnd )
-        {
-            double dtend = aTime - aSignalData.tEnd;
-
-            y = aSignalData.offset
-                + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dtend + aSignalData.phiRad ) * exp( aSignalData.damping * dtend );
-        }
-        else
-        {
-            y = aSignalData.offset;
-        }
-    }
-
-    return y;
+    mRenderEngine.seek( aPosition );
+    mSkipSamples = static_cast<size_t>( aPosition - mRenderEngine.getPosition() );
+    mPlayingCache = false;
 }
 
 
 //!************************************************************************
-//! Get the value of a WavSin signal
+//! Body of the render thread
+//! In real-time mode, the thread first raises its priority and pins itself
+//! to the last CPU, away from the GUI, and reports what it obtained.
+//! It then keeps the ring buffer full until stopRenderThread() is called,
+//! and copies the cache entry being extended while the ring is full.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueWavSin
+void AudioSource::runRenderThread
     (
-    const SignalItem::SignalWavSin      aSignalData,    //!< WavSin signal data
-    const double                        aTime           //!< time
-    ) const
+    std::promise<unsigned>  aPromoted   //!< receives the guarantees obtained by the thread
+    )
 {
-    double y = 0;
+    unsigned guarantees = 0;
 
-    if( aTime >= aSignalData.tDelay )
+    if( mRealTimeEnabled )
     {
-        uint8_t N = aSignalData.index;
+        const unsigned nrOfCpus = std::thread::hardware_concurrency();
 
-        if( N < 3
-         || N % 2 != 1
-          )
+        if( RealTime::promoteCurrentThread() )
         {
-            N = 3;
+            guarantees |= RealTime::GUARANTEE_PRIORITY;
         }
 
-        double b = aSignalData.freqHz / N;
-        double T = 0.5 / b;
-        double dt0 = aTime - aSignalData.tDelay;
-
-        if( aTime < T + aSignalData.tDelay )
+        if( nrOfCpus > 1 && RealTime::pinCurrentThread( nrOfCpus - 1 ) )
         {
-            y = aSignalData.offset
-                + aSignalData.amplit * sin( 2 * M_PI * b * dt0 ) * sin( 2 * M_PI * aSignalData.freqHz * dt0 );
+            guarantees |= RealTime::GUARANTEE_AFFINITY;
         }
     }
 
-    return y;
+    aPromoted.set_value( guarantees );
+
+    while( mRenderRunning.load() )
+    {
+        if( !renderBlock() && !copyCachedSamples() )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( RENDER_IDLE_MS ) );
+        }
+    }
 }
 
 
 //!************************************************************************
-//! Get the value of a AmSin signal
+//! Move playback to a sample index of the signal
+//!
+//! The position is taken modulo the audio buffer length and kept for the
+//! next starts. While started, the ring buffer is dropped and refilled
+//! from the new position; like readData(), this must be called from the
+//! thread of the audio output.
+//! Deterministic items and the Gauss and NAG noise jump directly, DEK
+//! noise is stepped over the skipped samples, and filtered noise costs
+//! one RenderEngine::CHUNK_ALIGNMENT period of warm-up.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueAmSin
+void AudioSource::seek
     (
-    const SignalItem::SignalAmSin       aSignalData,    //!< AmSin signal data
-    const double                        aTime           //!< time
-    ) const
+    const uint64_t  aPosition       //!< sample index
+    )
 {
-    double y = 0;
+    mStartPosition = aPosition;
 
-    if( aTime >= aSignalData.carrierTDelay )
+    if( isOpen() )
     {
-        double dt0 = aTime - aSignalData.carrierTDelay;
-
-        y = aSignalData.carrierOffset
-            + aSignalData.carrierAmplitude * sin( 2 * M_PI * aSignalData.carrierFreqHz * dt0 )
-            * ( 1 + aSignalData.modulationIndex * cos( 2 * M_PI * aSignalData.modulationFreqHz * dt0 + aSignalData.modulationPhiRad ) );
+        startRendering();
     }
-
-    return y;
 }
 
 
 //!************************************************************************
-//! Get the value of a SinDampSin signal
+//! Set the audio buffer length [seconds]
+//! The length is applied at the next start, so changing it renders
+//! nothing by itself.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueSinDampSin
+void AudioSource::setBufferLength
     (
-    const SignalItem::SignalSinDampSin  aSignalData,    //!< SinDampSin signal data
-    const double                        aTime           //!< time
-    ) const
+    const uint32_t aLength          //!< a length in seconds
+    )
 {
-    double y = 0;
-
-    if( aTime >= aSignalData.tDelay )
-    {
-        double eyeAmplit = aSignalData.amplit;
-        double dt0 = aTime - aSignalData.tDelay;
-        uint32_t kPer = 1 + dt0 / aSignalData.tPeriodEnv;
-
-        switch( aSignalData.dampingType )
-        {
-            case 0:
-                break;
-
-            case -3:
-                eyeAmplit *= exp( kPer - 1.0 );
-                break;
-
-            case -2:
-            case -1:
-            case 1:
-            case 2:
-                eyeAmplit *= pow( static_cast<double>( kPer ), -aSignalData.dampingType );
-                break;
-
-            case 3:
-                eyeAmplit *= exp( -( kPer - 1.0 ) );
-                break;
-
-            default:
-                eyeAmplit = 0;
-                break;
-        }
-
-        y = aSignalData.offset
-                + eyeAmplit * sin( M_PI / aSignalData.tPeriodEnv * dt0 ) * sin( 2 * M_PI * aSignalData.freqSinHz * dt0 );
-    }
-
-    return y;
+    mRequestedBufferLengthSeconds = aLength;
 }
 
 
 //!************************************************************************
-//! Get the value of a TrapDampSin signal
+//! Use a render cache in a directory
+//! The cache is not used in real-time mode, where the render thread
+//! must neither write files nor fault in pages of a mapped entry.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueTrapDampSin
+void AudioSource::setCacheDirectory
     (
-    const SignalItem::SignalTrapDampSin aSignalData,    //!< TrapDampSin signal data
-    const double                        aTime           //!< time
-    ) const
+    const std::string&  aDirectory,     //!< cache directory
+    const uint64_t      aMaxSize        //!< maximum size of the cache [bytes]
+    )
 {
-    double y = 0;
-
-    if( aTime >= aSignalData.tDelay )
-    {
-        double dt0 = aTime - aSignalData.tDelay;
-        uint32_t kPer = 1 + dt0 / aSignalData.tPeriod;
+    stop();
 
-        if( aTime >= aSignalData.tCross
-       || ( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
-         && aTime < aSignalData.tDelay + kPer * aSignalData.tPeriod )
-          )
-        {
-            y = aSignalData.offset;
-        }
-        else
-        {
-            double yEnv = 0;
+    mRenderCache.reset( new RenderCache( aDirectory, aMaxSize ) );
+}
 
-            if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod
-            &&  aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
-              )
-            {
-                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
-                yEnv /= aSignalData.tCross;
 
-                y = ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) / aSignalData.tRise;
-                y *= yEnv;
-            }
-            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
-                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
-                   )
-            {
-                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
-                yEnv /= aSignalData.tCross;
+//!************************************************************************
+//! Set the data for entire waveform
+//!
+//! @returns: nothing
+//!************************************************************************
+void AudioSource::setData
+    (
+    const std::vector<SignalItem*>  aSignalsVector  //!< signals vector
+    )
+{
+    stop();
 
-                y = yEnv - aSignalData.amplit * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise ) / aSignalData.tCross;
-            }
-            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
-                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
-                  )
-            {
-                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth );
-                yEnv /= aSignalData.tCross;
+    deleteLiveData( mPendingData.exchange( nullptr ) );
+    deleteLiveData( mRetiredData.exchange( nullptr ) );
 
-                y = 1 - ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
-                y *= yEnv;
-            }
+    mItemsHash = RenderCache::hashItems( aSignalsVector );
+    mLiveEdited = false;
 
-            y *= sin( 2 * M_PI * aSignalData.freqHz * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) );
-            y += aSignalData.offset;
-        }
-    }
-
-    return y;
+    mRenderEngine.setData( aSignalsVector );
+    mRenderEngine.setSeed( RenderCache::getSeed( mItemsHash ) );
 }
 
 
 //!************************************************************************
-//! Get the value of a white Noise signal
-//! An array of such values can be filtered for obtaining violet, blue,
-//! pink, or brown noise.
+//! Publish new parameters for the signal items, from the GUI thread
+//!
+//! The update, including the noise filters, is prepared here (see
+//! RenderEngine::prepareUpdate()) and the render thread applies it at
+//! its next block. Parameters published before the previous ones were
+//! taken replace them. The updates applied since the previous call are
+//! freed here, so the render thread neither allocates nor frees, and
+//! neither side ever waits for the other.
 //!
-//! @returns The signal value at a specified moment
+//! @returns: nothing
 //!************************************************************************
-double AudioSource::getSignalValueNoise
+void AudioSource::setLiveData
     (
-    const SignalItem::SignalNoise       aSignalData,    //!< Noise signal data
-    const double                        aTime           //!< time
-    ) const
+    const std::vector<SignalItem>&  aSignalsVector  //!< new parameters of the signal items
+    )
 {
-    double y = 0;
-    static int32_t seedNag = rand();
-
-    if( aTime >= aSignalData.tDelay )
-    {
-        switch( aSignalData.noiseType )
-        {
-            case SignalItem::NOISE_TYPE_DEK:
-                {
-                    int32_t seedDek = 1;
-                    y = generateRandomDek( &seedDek );  // [0..1]
-                    y = 2 * y - 1;                      // [-1..1]
-                    y *= aSignalData.amplit;            // [-a..a]
-                    y += aSignalData.offset;
-                }
-                break;
-
-            case SignalItem::NOISE_TYPE_NAG:
-                {
-                    y = generateRandomNag( &seedNag );  // [0..1]
-                    y = 2 * y - 1;                      // [-1..1]
-                    y *= aSignalData.amplit;            // [-a..a]
-                    y += aSignalData.offset;
-                }
-                break;
-
-            default:
-                break;
-        }
-    }
+    LiveData* liveData = new LiveData;
+    liveData->next = nullptr;
+    mRenderEngine.prepareUpdate( aSignalsVector, liveData->update );
 
-    return y;
+    deleteLiveData( mRetiredData.exchange( nullptr ) );
+    deleteLiveData( mPendingData.exchange( liveData ) );
 }
 
 
 //!************************************************************************
-//! Check if the audio source is started
+//! Request real-time guarantees for the render thread
+//! The request is applied at the next start.
 //!
-//! @returns: If the device is open
+//! @returns: nothing
 //!************************************************************************
-bool AudioSource::isStarted() const
+void AudioSource::setRealTime
+    (
+    const bool      aEnabled        //!< request real-time guarantees for the render thread
+    )
 {
-    return isOpen();
+    mRealTimeEnabled = aEnabled;
 }
 
 
 //!************************************************************************
-//! Pseudo DES (Data Encryption Standard)
-//! adapted from Press, W.H. et al - Numerical Recipes in C. The Art of Scientific Computing
-//!                                  2nd Ed, Cambridge Univ. Press, 1992
-//! see psdes(), subchapter 7.5, page 302
-//!
-//! This function is used by generateRandomNag()
+//! Start the audio source
+//! Playback starts at the position set by seek().
 //!
 //! @returns: nothing
 //!************************************************************************
-void AudioSource::pseudoDes
-    (
-    uint32_t*   lword,      //!< left word
-    uint32_t*   irword      //!< right word
-    ) const
+void AudioSource::start()
 {
-    const uint8_t NITER = 4;
-    const uint32_t C1[NITER] = { 0xbaa96887, 0x1e17d32c, 0x03bcdc3c, 0x0f33d1b2 };
-    const uint32_t C2[NITER] = { 0x4b0f3b58, 0xe874f0c3, 0x6955c5a6, 0x55a7ca46 };
-    uint32_t iswap = 0;
-
-    for( uint8_t i = 0; i < NITER; i++ )
-    {
-        uint32_t ia = ( iswap = ( *irword ) ) ^ C1[i];
-        uint32_t itmpl = ia & 0xffff;
-        uint32_t itmph = ia >> 16;
-        uint32_t ib = itmpl * itmpl + ~( itmph * itmph );
-        *irword = ( *lword ) ^ ( ( ( ia = ( ib >> 16 ) | ( ( ib & 0xffff ) << 16 ) ) ^ C2[i] ) + itmpl * itmph );
-        *lword = iswap;
-    }
+    startRendering();
+    open( QIODevice::ReadOnly );
 }
 
 
 //!************************************************************************
-//! Reads up to aLength bytes from the device into aData
-//! see QIODevice::readData()
+//! Start recording the rendered samples into the cache entry, from the
+//! end of the existing entry (or from the start of the signal) up to the
+//! audio buffer length
+//! An existing entry is copied to the recorder by copyCachedSamples() on
+//! the render thread, before the first rendered sample is recorded; if
+//! rendering reaches the end of the entry first, the recording is dropped.
 //!
-//! @returns: Number of bytes read
+//! @returns: nothing
 //!************************************************************************
-qint64 AudioSource::readData
+void AudioSource::startCacheRecording
     (
-    char*   aData,          //!< data content
-    qint64  aLength         //!< data length
+    const bool      aExtend         //!< an existing, shorter entry may be extended
     )
 {
-    qint64 bytesRead = 0;
-
-    if( !mAudioBuffer.isEmpty() )
+    if( mRenderCache && !mLiveEdited && !mRealTimeEnabled && mCachedLength < getLoopLength() )
     {
-        while( aLength - bytesRead > 0 )
+        if( 0 == mCachedLength || aExtend )
         {
-            const qint64 chunk = qMin( ( mAudioBuffer.size() - mBufferPos ), aLength - bytesRead );
-            memcpy( aData + bytesRead, mAudioBuffer.constData() + mBufferPos, chunk );
-            mBufferPos = ( mBufferPos + chunk ) % mAudioBuffer.size();
-            bytesRead += chunk;
+            mCacheRecorder.open( mRenderCache->getTempFileName( mCacheKey ), std::ios::binary | std::ios::trunc );
         }
-    }
 
-    return bytesRead;
+        mCopyPosition = 0;
+        mRecordPosition = mCachedLength;
+    }
 }
 
 
 //!************************************************************************
-//! Set the audio buffer length [seconds]
+//! (Re)start rendering from the start position
+//! The ring buffer is filled before the render thread is started, then
+//! the thread keeps it full. In real-time mode the buffers used by the
+//! render thread, including the scratch buffers of the engine, are
+//! locked in RAM first.
 //!
 //! @returns: nothing
 //!************************************************************************
-void AudioSource::setBufferLength
-    (
-    const uint32_t aLength          //!< a length in seconds
-    )
+void AudioSource::startRendering()
 {
-    mAudioBufferLengthSeconds = aLength;
+    stopRenderThread();
 
-    mBufferPos = 0;
-    close();
+    mRingBuffer.reset();
+
+    mAudioBufferLengthSeconds = mRequestedBufferLengthSeconds;
+
+    mStats.reset();
+    mRenderEngine.resetStats();
+
+    {
+        std::lock_guard<std::mutex> lock( mStatsMutex );
+        mPublishedStats.reset();
+    }
+
+    const uint64_t loopLength = getLoopLength();
+    const uint64_t position = loopLength ? mStartPosition % loopLength : 0;
+
+    mCacheKey = RenderCache::getKey( mItemsHash,
+                                     mRenderEngine.getSeed(),
+                                     static_cast<uint32_t>( mAudioFormat.sampleRate() ),
+                                     static_cast<uint32_t>( mAudioFormat.channelCount() ),
+                                     static_cast<uint32_t>( mAudioFormat.sampleSize() )
+                                    );
+    findCachedLoop();
+
+    if( position < mCachedLength )
+    {
+        mPlayingCache = true;
+        mCachePosition = position;
+        mSkipSamples = 0;
+    }
+    else
+    {
+        renderFrom( position );
+    }
+
+    if( position <= mCachedLength )
+    {
+        startCacheRecording( true );
+    }
 
-    mAudioBuffer.clear();
+    mRenderedPosition = position;
 
     if( mAudioFormat.isValid() )
     {
-        fillDataBuffer();
+        if( mRealTimeEnabled )
+        {
+            if( mRingBuffer.lockMemory()
+             && RealTime::lockMemory( mRenderData.data(), mRenderData.size() * sizeof( double ) )
+             && RealTime::lockMemory( mRenderSamples.data(), mRenderSamples.size() * sizeof( int16_t ) )
+             && mRenderEngine.lockMemory()
+              )
+            {
+                mRealTimeGuarantees = RealTime::GUARANTEE_MEMORY_LOCK;
+            }
+            else
+            {
+                unlockBuffers();
+            }
+        }
+
+        while( renderBlock() )
+        {
+        }
+
+        std::promise<unsigned> promoted;
+        std::future<unsigned> guarantees = promoted.get_future();
+
+        mRenderRunning = true;
+        mRenderThread = std::thread( &AudioSource::runRenderThread, this, std::move( promoted ) );
+        mRealTimeGuarantees |= guarantees.get();
     }
 }
 
 
 //!************************************************************************
-//! Set the data for entire waveform
+//! Stop the audio source
 //!
 //! @returns: nothing
 //!************************************************************************
-void AudioSource::setData
-    (
-    const std::vector<SignalItem*>  aSignalsVector  //!< signals vector
-    )
+void AudioSource::stop()
 {
-    mBufferPos = 0;
+    stopRenderThread();
     close();
+}
 
-    mAudioBuffer.clear();
-    mSignalsVector.clear();
 
-    for( size_t i = 0; i < aSignalsVector.size(); i++ )
+//!************************************************************************
+//! Stop recording a cache entry
+//!
+//! @returns: nothing
+//!************************************************************************
+void AudioSource::stopCacheRecording
+    (
+    const bool      aCommit         //!< keep the recorded entry
+    )
+{
+    if( mCacheRecorder.is_open() )
     {
-        mSignalsVector.push_back( aSignalsVector.at( i ) );
-    }
+        mCacheRecorder.close();
 
-    if( mAudioFormat.isValid() )
-    {
-        fillDataBuffer();
+        if( aCommit && !mCacheRecorder.fail() )
+        {
+            mRenderCache->commit( mCacheKey );
+        }
+        else
+        {
+            mRenderCache->discard( mCacheKey );
+        }
     }
+
+    mCacheRecorder.clear();
 }
 
 
 //!************************************************************************
-//! Start the audio source
+//! Stop the render thread and wait for it to finish
 //!
 //! @returns: nothing
 //!************************************************************************
-void AudioSource::start()
+void AudioSource::stopRenderThread()
 {
-    open( QIODevice::ReadOnly );
+    mRenderRunning = false;
+
+    if( mRenderThread.joinable() )
+    {
+        mRenderThread.join();
+    }
+
+    stopCacheRecording( false );
+
+    if( mRealTimeGuarantees & RealTime::GUARANTEE_MEMORY_LOCK )
+    {
+        unlockBuffers();
+    }
+
+    mRealTimeGuarantees = 0;
 }
 
 
 //!************************************************************************
-//! Stop the audio source
+//! Unlock the buffers locked for real-time mode
 //!
 //! @returns: nothing
 //!************************************************************************
-void AudioSource::stop()
+void AudioSource::unlockBuffers()
 {
-    mBufferPos = 0;
-    close();
+    mRingBuffer.unlockMemory();
+    RealTime::unlockMemory( mRenderData.data(), mRenderData.size() * sizeof( double ) );
+    RealTime::unlockMemory( mRenderSamples.data(), mRenderSamples.size() * sizeof( int16_t ) );
+    mRenderEngine.unlockMemory();
 }
 
 
@@ -24,21 +24,80 @@ This file contains the definitions for the audio source.
 #define AudioSource_h
 
 #include <QAudioOutput>
-#include <QByteArray>
 #include <QIODevice>
 
+#include <atomic>
 #include <cstdint>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "MappedFile.h"
+#include "RenderCache.h"
+#include "RenderEngine.h"
+#include "RenderStats.h"
+#include "RingBuffer.h"
 #include "SignalItem.h"
 
 
 //************************************************************************
 // Class for handling the audio source
+//
+// While started, a dedicated render thread renders the signal in blocks
+// into a ring buffer, and readData() only copies from the ring, so the
+// audio pull never waits for the render engine. The signal repeats every
+// audio buffer length, with the same noise in every repetition.
+// In real-time mode the render thread is scheduled with a real-time
+// policy and pinned to a CPU, and its buffers are locked in RAM.
+// Parameters changed during playback are prepared by setLiveData(),
+// published by swapping a pointer, and applied by the render thread at
+// the next block, so the change is heard after at most the ring buffer
+// length. The render thread hands the data it no longer needs back to be
+// freed by the GUI thread, so it never allocates, frees or waits for a lock.
+// Playback can start at any sample of the signal with seek(), without
+// rendering the samples before it (see RenderEngine::seek()).
+// With a render cache, outside real-time mode, the first complete
+// repetition is recorded, and later starts of the same signal play the
+// cached samples instead of rendering them; after a longer audio buffer
+// length, only the samples past the cached ones are rendered, and the
+// entry is extended by the render thread while it is idle. The seed
+// is derived from the signal items, so the same items always give the
+// same samples.
+// The time and bytes of each render stage since start are published by
+// the render thread after each block, see getRenderStats().
 //************************************************************************
 class AudioSource : public QIODevice
 {
     Q_OBJECT
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        struct RingStats
+        {
+            size_t      capacity;           //!< capacity of the ring [samples]
+            size_t      fillLevel;          //!< current fill level [samples]
+            size_t      minFillLevel;       //!< lowest fill level since start [samples]
+            uint64_t    nrOfUnderruns;      //!< reads padded with silence since start
+        };
+
+    private:
+        struct LiveData
+        {
+            RenderEngine::LiveUpdate    update;     //!< update of the engine, prepared by setLiveData()
+            LiveData*                   next;       //!< next retired entry
+        };
+
+        static const size_t RING_BUFFER_SIZE = 1 << 13;                                 //!< capacity of the ring [samples], bounds the latency of live updates
+        static const size_t RENDER_BLOCK_SIZE = 4 * RenderEngine::CHUNK_ALIGNMENT;      //!< samples rendered at once by the render thread
+        static const int RENDER_IDLE_MS = 5;                                            //!< wait of the render thread when the ring is full [ms]
+        static const size_t CACHE_COPY_SIZE = 1 << 16;                                  //!< samples of an entry copied at once while extending it
+
+
     //************************************************************************
     // functions
     //************************************************************************
@@ -49,8 +108,20 @@ class AudioSource : public QIODevice
             const uint32_t      aBufferLengthSeconds    //!< audio buffer length [seconds]
             );
 
+        ~AudioSource() override;
+
         qint64 bytesAvailable() const override;
 
+        const QAudioFormat& getFormat() const;
+
+        uint64_t getPosition() const;
+
+        unsigned getRealTimeGuarantees() const;
+
+        RenderStats getRenderStats() const;
+
+        RingStats getRingStats() const;
+
         bool isStarted() const;
 
         qint64 readData
@@ -59,16 +130,37 @@ class AudioSource : public QIODevice
             qint64      aLength             //!< data length
             ) override;
 
+        void seek
+            (
+            const uint64_t  aPosition       //!< sample index
+            );
+
         void setBufferLength
             (
             const uint32_t aLength          //!< a length in seconds
             );
 
+        void setCacheDirectory
+            (
+            const std::string&  aDirectory,                                 //!< cache directory
+            const uint64_t      aMaxSize = RenderCache::DEFAULT_MAX_SIZE    //!< maximum size of the cache [bytes]
+            );
+
         void setData
             (
             const std::vector<SignalItem*>  aSignalsVector  //!< signals vector
             );
 
+        void setLiveData
+            (
+            const std::vector<SignalItem>&  aSignalsVector  //!< new parameters of the signal items
+            );
+
+        void setRealTime
+            (
+            const bool      aEnabled        //!< request real-time guarantees for the render thread
+            );
+
         void start();
 
         void stop();
@@ -81,97 +173,44 @@ class AudioSource : public QIODevice
 
 
     private:
-        void fillDataBuffer();
-
-        double generateRandomDek
-            (
-            int32_t*   pIdum                //!< seed value
-            ) const;
-
-        double generateRandomNag
-            (
-            int32_t*   pIdum                //!< seed value
-            ) const;
-
-
-        double getSignalValue
-            (
-            const double         aTime      //!< time
-            ) const;
-
-
-        double getSignalValueTriangle
-            (
-            const SignalItem::SignalTriangle    aSignalData,    //!< Triangle signal data
-            const double                        aTime           //!< time
-            ) const;
+        bool copyCachedSamples();
 
-        double getSignalValueRectangle
+        static void deleteLiveData
             (
-            const SignalItem::SignalRectangle   aSignalData,    //!< Rectangle signal data
-            const double                        aTime           //!< time
-            ) const;
-
-        double getSignalValuePulse
-            (
-            const SignalItem::SignalPulse       aSignalData,    //!< Pulse signal data
-            const double                        aTime           //!< time
-            ) const;
+            LiveData*       aLiveData       //!< first entry of a list, may be null
+            );
 
-        double getSignalValueRiseFall
-            (
-            const SignalItem::SignalRiseFall    aSignalData,    //!< RiseFall signal data
-            const double                        aTime           //!< time
-            ) const;
+        void findCachedLoop();
 
-        double getSignalValueSinDamp
-            (
-            const SignalItem::SignalSinDamp     aSignalData,    //!< SinDamp signal data
-            const double                        aTime           //!< time
-            ) const;
+        uint64_t getLoopLength() const;
 
-        double getSignalValueSinRise
-            (
-            const SignalItem::SignalSinRise     aSignalData,    //!< SinRise signal data
-            const double                        aTime           //!< time
-            ) const;
+        bool renderBlock();
 
-        double getSignalValueWavSin
+        void renderFrom
             (
-            const SignalItem::SignalWavSin      aSignalData,    //!< WavSin signal data
-            const double                        aTime           //!< time
-            ) const;
+            const uint64_t  aPosition       //!< sample index
+            );
 
-        double getSignalValueAmSin
+        void runRenderThread
             (
-            const SignalItem::SignalAmSin       aSignalData,    //!< AmSin signal data
-            const double                        aTime           //!< time
-            ) const;
+            std::promise<unsigned>  aPromoted   //!< receives the guarantees obtained by the thread
+            );
 
-        double getSignalValueSinDampSin
+        void startCacheRecording
             (
-            const SignalItem::SignalSinDampSin  aSignalData,    //!< SinDampSin signal data
-            const double                        aTime           //!< time
-            ) const;
+            const bool      aExtend         //!< an existing, shorter entry may be extended
+            );
 
-        double getSignalValueTrapDampSin
-            (
-            const SignalItem::SignalTrapDampSin aSignalData,    //!< TrapDampSin signal data
-            const double                        aTime           //!< time
-            ) const;
+        void startRendering();
 
-        double getSignalValueNoise
+        void stopCacheRecording
             (
-            const SignalItem::SignalNoise       aSignalData,    //!< Noise signal data
-            const double                        aTime           //!< time
-            ) const;
+            const bool      aCommit         //!< keep the recorded entry
+            );
 
+        void stopRenderThread();
 
-        void pseudoDes
-            (
-            uint32_t*   lword,      //!< left word
-            uint32_t*   irword      //!< right word
-            ) const;
+        void unlockBuffers();
 
 
     //************************************************************************
@@ -180,9 +219,34 @@ class AudioSource : public QIODevice
     private:
         QAudioFormat                mAudioFormat;               //!< audio format
         uint32_t                    mAudioBufferLengthSeconds;  //!< length of audio buffer [seconds]
-        qint64                      mBufferPos;                 //!< current position in data buffer
-        QByteArray                  mAudioBuffer;               //!< audio data buffer
-        std::vector<SignalItem*>    mSignalsVector;             //!< signals vector
+        uint32_t                    mRequestedBufferLengthSeconds;  //!< length of audio buffer applied at the next start [seconds]
+        RenderEngine                mRenderEngine;              //!< render engine, used by the render thread while started
+        RingBuffer                  mRingBuffer;                //!< samples passed from the render thread to readData()
+        std::thread                 mRenderThread;              //!< render thread
+        std::atomic<bool>           mRenderRunning;             //!< the render thread must keep running
+        std::vector<double>         mRenderData;                //!< block rendered by the engine
+        std::vector<int16_t>        mRenderSamples;             //!< quantized block
+        uint64_t                    mStartPosition;             //!< sample index where rendering starts, set by seek()
+        size_t                      mSkipSamples;               //!< samples to drop from the next block, to start between two chunk boundaries
+        std::atomic<uint64_t>       mRenderedPosition;          //!< index of the next sample written to the ring
+        uint64_t                    mItemsHash;                 //!< hash of the signal items set by setData()
+        bool                        mLiveEdited;                //!< the items were changed by setLiveData() since setData()
+        std::unique_ptr<RenderCache>    mRenderCache;           //!< render cache, may be null
+        std::string                 mCacheKey;                  //!< key of the signal in the render cache
+        std::unique_ptr<MappedFile> mCachedLoop;                //!< cache entry of the signal, may be null
+        uint64_t                    mCachedLength;              //!< samples of the entry within the audio buffer length
+        bool                        mPlayingCache;              //!< samples are copied from the entry instead of rendered
+        uint64_t                    mCachePosition;             //!< index of the next cached sample
+        std::ofstream               mCacheRecorder;             //!< receives the rendered samples while recording a cache entry
+        uint64_t                    mRecordPosition;            //!< index of the next sample expected by the recorder
+        uint64_t                    mCopyPosition;              //!< index of the next sample of the entry copied to the recorder, when extending it
+        std::atomic<LiveData*>      mPendingData;               //!< update published by setLiveData(), taken by the render thread
+        std::atomic<LiveData*>      mRetiredData;               //!< list of the updates applied by the render thread, freed by setLiveData()
+        bool                        mRealTimeEnabled;           //!< real-time guarantees are requested
+        unsigned                    mRealTimeGuarantees;        //!< guarantees obtained, RealTime::Guarantee flags
+        RenderStats                 mStats;                     //!< render stages since start, updated by the render thread
+        RenderStats                 mPublishedStats;            //!< copy of mStats read by getRenderStats()
+        mutable std::mutex          mStatsMutex;                //!< protects mPublishedStats
 };
 
 #endif // AudioSource_h
@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BatchRenderer.cpp
+This file contains the sources for the batch renderer.
+*/
+
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "NoisePwrSpectrum.h"
+#include "PresetFile.h"
+#include "RenderCache.h"
+#include "RenderEngine.h"
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+BatchRenderer::BatchRenderer
+    (
+    const uint32_t  aSampleRate,        //!< sample rate [Hz]
+    const uint64_t  aNrOfSamples        //!< number of samples of every file
+    )
+    : mSampleRate( aSampleRate )
+    , mNrOfSamples( aNrOfSamples )
+    , mHasSeed( false )
+    , mSeed( 0 )
+    , mMaxJobs( 0 )
+    , mMemoryBudget( 0 )
+    , mNrOfBlocks( 0 )
+    , mPoleDensity( 0 )
+    , mNextJob( 0 )
+    , mNrOfFinishedJobs( 0 )
+    , mMemoryInUse( 0 )
+{
+}
+
+
+//!************************************************************************
+//! Override the noise filter design of all the noise items
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::applyNoiseDesign
+    (
+    const std::vector<SignalItem*>& aSignalsVector, //!< signals vector
+    const int                       aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+    const double                    aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+    )
+{
+    for( auto& crtSignal : aSignalsVector )
+    {
+        if( SignalItem::SIGNAL_TYPE_NOISE == crtSignal->getType() )
+        {
+            SignalItem::SignalNoise sig = crtSignal->getSignalDataNoise();
+
+            if( aNrOfBlocks )
+            {
+                sig.nrOfBlocks = aNrOfBlocks;
+            }
+
+            if( aPoleDensity )
+            {
+                sig.poleDensity = aPoleDensity;
+            }
+
+            *crtSignal = SignalItem( sig );
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Build the jobs for a directory of presets or for a list file
+//!
+//! A directory provides all its *.txt and binary preset files, in name
+//! order. A list file provides one preset file name per line; empty lines
+//! and lines starting with '#' are skipped. Every preset is rendered to a
+//! WAV file with the same base name, in aOutDir or next to the preset.
+//!
+//! @returns: true if the source could be read
+//!************************************************************************
+bool BatchRenderer::collectJobs
+    (
+    const std::string&  aSource,        //!< preset directory or list file
+    const std::string&  aOutDir,        //!< output directory, empty for the preset directory
+    std::vector<Job>&   aJobVec         //!< jobs, appended
+    )
+{
+    std::error_code errorCode;
+    std::vector<std::filesystem::path> presetVec;
+    bool status = true;
+
+    if( std::filesystem::is_directory( aSource, errorCode ) )
+    {
+        for( const auto& crtEntry : std::filesystem::directory_iterator( aSource, errorCode ) )
+        {
+            if( crtEntry.is_regular_file( errorCode )
+             && ( ".txt" == crtEntry.path().extension() || PresetFile::BINARY_EXTENSION == crtEntry.path().extension() ) )
+            {
+                presetVec.push_back( crtEntry.path() );
+            }
+        }
+
+        std::sort( presetVec.begin(), presetVec.end() );
+        status = !errorCode;
+    }
+    else
+    {
+        std::ifstream listFile( aSource );
+        std::string line;
+
+        status = listFile.is_open();
+
+        while( std::getline( listFile, line ) )
+        {
+            line.erase( line.find_last_not_of( " \t\r" ) + 1 );
+
+            if( !line.empty() && '#' != line[0] )
+            {
+                presetVec.push_back( line );
+            }
+        }
+    }
+
+    for( const auto& crtPreset : presetVec )
+    {
+        std::filesystem::path outPath = aOutDir.empty() ? crtPreset.parent_path() : std::filesystem::path( aOutDir );
+        outPath /= crtPreset.stem();
+        outPath += ".wav";
+
+        aJobVec.push_back( { crtPreset.string(), outPath.string() } );
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Render one job
+//!
+//! The preset is read and its memory estimate is reserved from the budget
+//! before rendering, waiting for running jobs to finish if needed. A job
+//! is always started when no other job is running, so that a job larger
+//! than the whole budget is rendered alone instead of blocking the queue.
+//!
+//! @returns: the result of the job
+//!************************************************************************
+BatchRenderer::JobResult BatchRenderer::renderJob
+    (
+    const Job&      aJob,               //!< job
+    const size_t    aNrOfJobs           //!< total number of jobs, for the progress
+    )
+{
+    JobResult result = { false, 0 };
+    std::vector<SignalItem*> signalsVector;
+    const char* error = nullptr;
+
+    if( !PresetFile::read( aJob.presetFileName, signalsVector ) )
+    {
+        error = "could not open file";
+    }
+    else if( signalsVector.empty() )
+    {
+        error = "no valid signal";
+    }
+    else
+    {
+        applyNoiseDesign( signalsVector, mNrOfBlocks, mPoleDensity );
+
+        const uint32_t seed = mHasSeed ? mSeed : RenderCache::getSeed( RenderCache::hashItems( signalsVector ) );
+        RenderEngine renderEngine( mSampleRate, seed );
+        renderEngine.setData( signalsVector );
+
+        const uint64_t memoryEstimate = renderEngine.getMemoryEstimate( mNrOfSamples );
+
+        {
+            std::unique_lock<std::mutex> lock( mMutex );
+
+            mMemoryCondition.wait( lock, [this, memoryEstimate]()
+                                   {
+                                       return 0 == mMemoryBudget
+                                           || 0 == mMemoryInUse
+                                           || mMemoryInUse + memoryEstimate <= mMemoryBudget;
+                                   } );
+
+            mMemoryInUse += memoryEstimate;
+        }
+
+        const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        result.done = renderEngine.renderToWav( aJob.outFileName, mNrOfSamples );
+        result.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+        if( !result.done )
+        {
+            error = "could not write output file";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mMutex );
+            mMemoryInUse -= memoryEstimate;
+        }
+
+        mMemoryCondition.notify_all();
+    }
+
+    for( auto& crtSignal : signalsVector )
+    {
+        delete crtSignal;
+    }
+
+    std::lock_guard<std::mutex> lock( mMutex );
+    mNrOfFinishedJobs++;
+
+    if( result.done )
+    {
+        printf( "[%zu/%zu] %s -> %s: %.2f s\n",
+                mNrOfFinishedJobs, aNrOfJobs,
+                aJob.presetFileName.c_str(), aJob.outFileName.c_str(),
+                result.seconds );
+    }
+    else
+    {
+        printf( "[%zu/%zu] %s: FAILED, %s\n",
+                mNrOfFinishedJobs, aNrOfJobs,
+                aJob.presetFileName.c_str(), error );
+    }
+
+    fflush( stdout );
+
+    return result;
+}
+
+
+//!************************************************************************
+//! Render all the jobs and print a summary of the timings
+//!
+//! At most setMaxJobs() jobs run concurrently. Each of them may use
+//! its share of the hardware threads for filtering noise.
+//!
+//! @returns: number of failed jobs
+//!************************************************************************
+size_t BatchRenderer::run
+    (
+    const std::vector<Job>& aJobVec     //!< jobs
+    )
+{
+    const unsigned nrOfCores = std::max( 1u, std::thread::hardware_concurrency() );
+    const unsigned nrOfWorkers = static_cast<unsigned>( std::min<size_t>( mMaxJobs ? mMaxJobs : nrOfCores, aJobVec.size() ) );
+
+    std::vector<JobResult> resultVec( aJobVec.size(), JobResult{ false, 0 } );
+    std::vector<std::thread> workerVec;
+
+    mNextJob = 0;
+    mNrOfFinishedJobs = 0;
+    mMemoryInUse = 0;
+
+    NoisePwrSpectrum::setMaxThreads( std::max( 1u, nrOfCores / std::max( 1u, nrOfWorkers ) ) );
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for( unsigned i = 0; i < nrOfWorkers; i++ )
+    {
+        workerVec.emplace_back( &BatchRenderer::runWorker, this, std::cref( aJobVec ), std::ref( resultVec ) );
+    }
+
+    for( auto& crtWorker : workerVec )
+    {
+        crtWorker.join();
+    }
+
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+    NoisePwrSpectrum::setMaxThreads( 0 );
+
+    size_t nrOfDone = 0;
+    double totalSeconds = 0;
+    double minSeconds = 0;
+    double maxSeconds = 0;
+
+    for( const auto& crtResult : resultVec )
+    {
+        if( crtResult.done )
+        {
+            minSeconds = nrOfDone ? std::min( minSeconds, crtResult.seconds ) : crtResult.seconds;
+            maxSeconds = std::max( maxSeconds, crtResult.seconds );
+            totalSeconds += crtResult.seconds;
+            nrOfDone++;
+        }
+    }
+
+    const double audioSeconds = static_cast<double>( mNrOfSamples ) * nrOfDone / mSampleRate;
+
+    printf( "Rendered %zu of %zu files with %u workers in %.2f s\n", nrOfDone, aJobVec.size(), nrOfWorkers, elapsed );
+
+    if( nrOfDone )
+    {
+        printf( "  job time: min %.2f s, mean %.2f s, max %.2f s, sum %.2f s\n",
+                minSeconds, totalSeconds / nrOfDone, maxSeconds, totalSeconds );
+        printf( "  %.1f s of audio, %.1fx real time, %.2fx parallel speed-up\n",
+                audioSeconds, elapsed > 0 ? audioSeconds / elapsed : 0, elapsed > 0 ? totalSeconds / elapsed : 0 );
+    }
+
+    return aJobVec.size() - nrOfDone;
+}
+
+
+//!************************************************************************
+//! Take jobs from the queue until it is empty
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::runWorker
+    (
+    const std::vector<Job>&     aJobVec,        //!< jobs
+    std::vector<JobResult>&     aResultVec      //!< results, one per job
+    )
+{
+    while( true )
+    {
+        size_t crtJob = 0;
+
+        {
+            std::lock_guard<std::mutex> lock( mMutex );
+
+            if( mNextJob >= aJobVec.size() )
+            {
+                break;
+            }
+
+            crtJob = mNextJob++;
+        }
+
+        aResultVec[crtJob] = renderJob( aJobVec[crtJob], aJobVec.size() );
+    }
+}
+
+
+//!************************************************************************
+//! Set the maximum number of jobs running concurrently
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::setMaxJobs
+    (
+    const unsigned  aMaxJobs            //!< maximum number of concurrent jobs, 0 for hardware concurrency
+    )
+{
+    mMaxJobs = aMaxJobs;
+}
+
+
+//!************************************************************************
+//! Set the memory budget shared by the running jobs
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::setMemoryBudget
+    (
+    const uint64_t  aMemoryBudget       //!< memory budget of all running jobs [bytes], 0 for unlimited
+    )
+{
+    mMemoryBudget = aMemoryBudget;
+}
+
+
+//!************************************************************************
+//! Set the noise filter design used instead of the one of the presets
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::setNoiseDesign
+    (
+    const int       aNrOfBlocks,        //!< number of noise filter blocks, 0 to keep the preset ones
+    const double    aPoleDensity        //!< poles / decade of the noise filters, 0 to keep the preset ones
+    )
+{
+    mNrOfBlocks = aNrOfBlocks;
+    mPoleDensity = aPoleDensity;
+}
+
+
+//!************************************************************************
+//! Render every preset with the same seed, instead of the seed derived
+//! from its items
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchRenderer::setSeed
+    (
+    const uint32_t  aSeed               //!< seed value of every preset
+    )
+{
+    mHasSeed = true;
+    mSeed = aSeed;
+}
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BatchRenderer.h
+This file contains the definitions for the batch renderer.
+*/
+
+#ifndef BatchRenderer_h
+#define BatchRenderer_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SignalItem.h"
+
+
+//************************************************************************
+// Class for rendering many preset files to WAV files
+//
+// The jobs are taken from a queue by a bounded pool of worker threads.
+// Each job renders one preset with its own RenderEngine. A job is only
+// started when its memory estimate fits the budget together with the
+// jobs already running, and the noise filters of every job share the
+// remaining hardware threads, so the machine is not oversubscribed.
+// Unless setSeed() is called, each preset is rendered with the seed the
+// GUI derives from its items.
+//************************************************************************
+class BatchRenderer
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        struct Job
+        {
+            std::string     presetFileName;     //!< input preset file
+            std::string     outFileName;        //!< output WAV file
+        };
+
+    private:
+        struct JobResult
+        {
+            bool            done;               //!< the job was rendered
+            double          seconds;            //!< render time [s]
+        };
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        BatchRenderer
+            (
+            const uint32_t  aSampleRate,        //!< sample rate [Hz]
+            const uint64_t  aNrOfSamples        //!< number of samples of every file
+            );
+
+        static void applyNoiseDesign
+            (
+            const std::vector<SignalItem*>& aSignalsVector, //!< signals vector
+            const int                       aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+            const double                    aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+            );
+
+        static bool collectJobs
+            (
+            const std::string&  aSource,        //!< preset directory or list file
+            const std::string&  aOutDir,        //!< output directory, empty for the preset directory
+            std::vector<Job>&   aJobVec         //!< jobs, appended
+            );
+
+        size_t run
+            (
+            const std::vector<Job>& aJobVec     //!< jobs
+            );
+
+        void setMaxJobs
+            (
+            const unsigned  aMaxJobs            //!< maximum number of concurrent jobs, 0 for hardware concurrency
+            );
+
+        void setMemoryBudget
+            (
+            const uint64_t  aMemoryBudget       //!< memory budget of all running jobs [bytes], 0 for unlimited
+            );
+
+        void setNoiseDesign
+            (
+            const int       aNrOfBlocks,        //!< number of noise filter blocks, 0 to keep the preset ones
+            const double    aPoleDensity        //!< poles / decade of the noise filters, 0 to keep the preset ones
+            );
+
+        void setSeed
+            (
+            const uint32_t  aSeed               //!< seed value of every preset
+            );
+
+    private:
+        JobResult renderJob
+            (
+            const Job&      aJob,               //!< job
+            const size_t    aNrOfJobs           //!< total number of jobs, for the progress
+            );
+
+        void runWorker
+            (
+            const std::vector<Job>&     aJobVec,        //!< jobs
+            std::vector<JobResult>&     aResultVec      //!< results, one per job
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        uint32_t                    mSampleRate;        //!< sample rate [Hz]
+        uint64_t                    mNrOfSamples;       //!< number of samples of every file
+        bool                        mHasSeed;           //!< mSeed is used instead of the seeds derived from the presets
+        uint32_t                    mSeed;              //!< seed value
+        unsigned                    mMaxJobs;           //!< maximum number of concurrent jobs
+        uint64_t                    mMemoryBudget;      //!< memory budget of all running jobs [bytes]
+        int                         mNrOfBlocks;        //!< number of noise filter blocks, 0 to keep the preset ones
+        double                      mPoleDensity;       //!< poles / decade of the noise filters, 0 to keep the preset ones
+
+        std::mutex                  mMutex;             //!< protects the variables below
+        std::condition_variable     mMemoryCondition;   //!< signalled when a job releases memory
+        size_t                      mNextJob;           //!< index of the next job to start
+        size_t                      mNrOfFinishedJobs;  //!< number of finished jobs
+        uint64_t                    mMemoryInUse;       //!< memory estimate of the running jobs [bytes]
+};
+
+#endif // BatchRenderer_h
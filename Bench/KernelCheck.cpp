@@ -0,0 +1,1209 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+KernelCheck.cpp
+This file contains the harness comparing the render paths of the engine
+against the scalar reference kernels.
+
+For every signal type, randomised parameter sets are rendered by the
+scalar getSignalValue* kernels of the original AudioSource, copied here
+verbatim, which are the reference, and by the render paths used for
+playback and files: render() in blocks from the start, after seek() to
+random positions and after seek() to one hour. Noise items, which have no scalar kernel of
+their own, are referenced by a single render of the whole window, and
+several gammas filtered in lanes are referenced by the sum of each gamma
+filtered alone. A noise item with a filter design other than the default
+one is read from a text and a binary preset and referenced by its white
+noise filtered by a NoisePwrSpectrum of that design.
+
+For each type the maximum absolute error, the RMS error and the phase
+drift after one hour are compared with the budgets of the type. The
+drift is the delay which best aligns the optimised output with the
+reference (least squares over the derivative of the reference). The time
+per sample of both paths and the speedup are reported as well.
+
+Usage: KernelCheck [parameter sets] [seed]
+The exit code is nonzero if any type exceeds its budgets.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NoisePwrSpectrum.h"
+#include "PresetFile.h"
+#include "RenderEngine.h"
+#include "SignalItem.h"
+
+
+static const uint32_t SAMPLE_RATE = 44100;              //!< sample rate of all renders [Hz]
+static const uint32_t ENGINE_SEED = 1;                  //!< seed of the render engines
+static const int DEFAULT_PARAMETER_SETS = 16;           //!< default number of parameter sets per type
+static const uint32_t DEFAULT_SEED = 1;                 //!< default seed of the parameter sets
+
+static const size_t WINDOW_SAMPLES = SAMPLE_RATE;       //!< samples rendered from the start
+static const size_t BLOCK_SIZE = 4 * RenderEngine::CHUNK_ALIGNMENT;     //!< block of the playback render thread
+static const int NR_OF_SEEKS = 4;                       //!< random seeks per parameter set
+static const uint32_t SEEK_RANGE_SECONDS = 60;          //!< seeks land within this time [s]
+static const uint32_t DRIFT_SECONDS = 3600;             //!< time where the phase drift is measured [s]
+static const size_t SEEK_SAMPLES = 8192;                //!< samples rendered after a seek
+
+static const double MIN_FREQ_HZ = 1;                    //!< lowest random frequency
+static const double MAX_FREQ_HZ = 20000;                //!< highest random frequency
+static const double MIN_PERIOD_S = 1e-3;                //!< shortest random period
+static const double MAX_PERIOD_S = 1;                   //!< longest random period
+
+struct ErrorBudget
+{
+    double      maxAbs;             //!< maximum absolute error
+    double      rms;                //!< RMS error
+    double      driftNs;            //!< phase drift after DRIFT_SECONDS [ns]
+};
+
+struct ErrorStats
+{
+    double      maxAbs;             //!< maximum absolute error
+    double      sumSquares;         //!< sum of the squared errors
+    double      count;              //!< number of compared samples
+    double      maxDriftNs;         //!< largest phase drift [ns]
+    double      refNs;              //!< time spent in the reference [ns]
+    double      optNs;              //!< time spent in the optimised path [ns]
+    double      timedSamples;       //!< samples rendered by each timed path
+
+    ErrorStats()
+        : maxAbs( 0 )
+        , sumSquares( 0 )
+        , count( 0 )
+        , maxDriftNs( 0 )
+        , refNs( 0 )
+        , optNs( 0 )
+        , timedSamples( 0 )
+    {
+    }
+};
+
+// amplitudes are at most 1, so the budgets are absolute
+static const ErrorBudget SMOOTH_BUDGET = { 1e-6, 1e-7, 100 };      //!< sinusoidal types
+static const ErrorBudget PIECEWISE_BUDGET = { 1e-9, 1e-10, 100 };  //!< piecewise linear and exponential types
+static const ErrorBudget NOISE_BUDGET = { 1e-9, 1e-10, 0 };        //!< noise, same generators and filters in both paths
+
+
+//************************************************************************
+// Reference kernels
+// The scalar kernels of AudioSource before the render engine, copied
+// verbatim, so the reference does not change with the engine.
+//************************************************************************
+
+//!************************************************************************
+//! Get the value of a Triangle signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueTriangle
+    (
+    const SignalItem::SignalTriangle    aSignalData,    //!< Triangle signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tRise )
+        {
+            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
+        }
+        else
+        {
+            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise ) / aSignalData.tFall;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a Rectangle signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueRectangle
+    (
+    const SignalItem::SignalRectangle   aSignalData,    //!< Rectangle signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tPeriod * aSignalData.fillFactor )
+        {
+            y = aSignalData.yMax;
+        }
+        else
+        {
+            y = aSignalData.yMin;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a Pulse signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValuePulse
+    (
+    const SignalItem::SignalPulse       aSignalData,    //!< Pulse signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tRise )
+        {
+            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
+        }
+        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth )
+        {
+            y = aSignalData.yMax;
+        }
+        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall )
+        {
+            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
+        }
+        else
+        {
+            y = aSignalData.yMin;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of an exponential RiseFall signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueRiseFall
+    (
+    const SignalItem::SignalRiseFall    aSignalData,    //!< RiseFall signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        if( aTime <= aSignalData.tDelayRise )
+        {
+            y = aSignalData.yMin;
+        }
+        else if( aTime > aSignalData.tDelayRise
+              && aTime <= aSignalData.tDelayFall
+               )
+        {
+            y = aSignalData.yMin
+                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) );
+
+        }
+        else if( aTime > aSignalData.tDelayFall )
+        {
+            y = aSignalData.yMin
+                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) )
+                + ( aSignalData.yMin - aSignalData.yMax ) * ( 1. - exp( -( aTime - aSignalData.tDelayFall ) / aSignalData.tRampFall ) );
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinDamp signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueSinDamp
+    (
+    const SignalItem::SignalSinDamp     aSignalData,    //!< SinDamp signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+
+        y = aSignalData.offset
+            + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dt0 + aSignalData.phiRad ) * exp( -aSignalData.damping * dt0 );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinRise signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueSinRise
+    (
+    const SignalItem::SignalSinRise     aSignalData,    //!< SinRise signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        if( aTime < aSignalData.tEnd )
+        {
+            double dtend = aTime - aSignalData.tEnd;
+
+            y = aSignalData.offset
+                + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dtend + aSignalData.phiRad ) * exp( aSignalData.damping * dtend );
+        }
+        else
+        {
+            y = aSignalData.offset;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a WavSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueWavSin
+    (
+    const SignalItem::SignalWavSin      aSignalData,    //!< WavSin signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        uint8_t N = aSignalData.index;
+
+        if( N < 3
+         || N % 2 != 1
+          )
+        {
+            N = 3;
+        }
+
+        double b = aSignalData.freqHz / N;
+        double T = 0.5 / b;
+        double dt0 = aTime - aSignalData.tDelay;
+
+        if( aTime < T + aSignalData.tDelay )
+        {
+            y = aSignalData.offset
+                + aSignalData.amplit * sin( 2 * M_PI * b * dt0 ) * sin( 2 * M_PI * aSignalData.freqHz * dt0 );
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a AmSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueAmSin
+    (
+    const SignalItem::SignalAmSin       aSignalData,    //!< AmSin signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.carrierTDelay )
+    {
+        double dt0 = aTime - aSignalData.carrierTDelay;
+
+        y = aSignalData.carrierOffset
+            + aSignalData.carrierAmplitude * sin( 2 * M_PI * aSignalData.carrierFreqHz * dt0 )
+            * ( 1 + aSignalData.modulationIndex * cos( 2 * M_PI * aSignalData.modulationFreqHz * dt0 + aSignalData.modulationPhiRad ) );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinDampSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueSinDampSin
+    (
+    const SignalItem::SignalSinDampSin  aSignalData,    //!< SinDampSin signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double eyeAmplit = aSignalData.amplit;
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = 1 + dt0 / aSignalData.tPeriodEnv;
+
+        switch( aSignalData.dampingType )
+        {
+            case 0:
+                break;
+
+            case -3:
+                eyeAmplit *= exp( kPer - 1.0 );
+                break;
+
+            case -2:
+            case -1:
+            case 1:
+            case 2:
+                eyeAmplit *= pow( static_cast<double>( kPer ), -aSignalData.dampingType );
+                break;
+
+            case 3:
+                eyeAmplit *= exp( -( kPer - 1.0 ) );
+                break;
+
+            default:
+                eyeAmplit = 0;
+                break;
+        }
+
+        y = aSignalData.offset
+                + eyeAmplit * sin( M_PI / aSignalData.tPeriodEnv * dt0 ) * sin( 2 * M_PI * aSignalData.freqSinHz * dt0 );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a TrapDampSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+static double getSignalValueTrapDampSin
+    (
+    const SignalItem::SignalTrapDampSin aSignalData,    //!< TrapDampSin signal data
+    const double                        aTime           //!< time
+    )
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = 1 + dt0 / aSignalData.tPeriod;
+
+        if( aTime >= aSignalData.tCross
+       || ( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
+         && aTime < aSignalData.tDelay + kPer * aSignalData.tPeriod )
+          )
+        {
+            y = aSignalData.offset;
+        }
+        else
+        {
+            double yEnv = 0;
+
+            if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod
+            &&  aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
+              )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
+                yEnv /= aSignalData.tCross;
+
+                y = ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) / aSignalData.tRise;
+                y *= yEnv;
+            }
+            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
+                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
+                   )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
+                yEnv /= aSignalData.tCross;
+
+                y = yEnv - aSignalData.amplit * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise ) / aSignalData.tCross;
+            }
+            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
+                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
+                  )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth );
+                yEnv /= aSignalData.tCross;
+
+                y = 1 - ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
+                y *= yEnv;
+            }
+
+            y *= sin( 2 * M_PI * aSignalData.freqHz * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) );
+            y += aSignalData.offset;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of the entire signal, obtained by superposition
+//! through the entire vector *without noise*
+//!
+//! @returns The value of the signal at a specified moment
+//!************************************************************************
+static double getSignalValue
+    (
+    const std::vector<SignalItem*>& aSignalsVector, //!< signals vector
+    const double aTime      //!< time
+    )
+{
+    double y = 0;
+
+    for( size_t i = 0; i < aSignalsVector.size(); i++ )
+    {
+        switch( aSignalsVector.at( i )->getType() )
+        {
+            case SignalItem::SIGNAL_TYPE_TRIANGLE:
+                y += getSignalValueTriangle( aSignalsVector.at( i )->getSignalDataTriangle(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RECTANGLE:
+                y += getSignalValueRectangle( aSignalsVector.at( i )->getSignalDataRectangle(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_PULSE:
+                y += getSignalValuePulse( aSignalsVector.at( i )->getSignalDataPulse(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RISEFALL:
+                y += getSignalValueRiseFall( aSignalsVector.at( i )->getSignalDataRiseFall(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMP:
+                y += getSignalValueSinDamp( aSignalsVector.at( i )->getSignalDataSinDamp(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINRISE:
+                y += getSignalValueSinRise( aSignalsVector.at( i )->getSignalDataSinRise(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_WAVSIN:
+                y += getSignalValueWavSin( aSignalsVector.at( i )->getSignalDataWavSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_AMSIN:
+                y += getSignalValueAmSin( aSignalsVector.at( i )->getSignalDataAmSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+                y += getSignalValueSinDampSin( aSignalsVector.at( i )->getSignalDataSinDampSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+                y += getSignalValueTrapDampSin( aSignalsVector.at( i )->getSignalDataTrapDampSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_NOISE: // intentionally skip noise type
+            default:
+                break;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Render items with the reference kernels, with the time of each sample
+//! computed as the original audio buffer loop did
+//!
+//! @returns: nothing
+//!************************************************************************
+static void renderReference
+    (
+    const std::vector<SignalItem*>& aSignalsVector, //!< signals vector
+    const uint64_t                  aFirstSample,   //!< index of the first sample
+    double*                         aData,          //!< output samples
+    const size_t                    aCount          //!< number of samples
+    )
+{
+    for( size_t k = 0; k < aCount; k++ )
+    {
+        const uint64_t i = aFirstSample + k;
+
+        double time = static_cast<double>( i % SAMPLE_RATE ) / SAMPLE_RATE;
+        time += static_cast<size_t>( i / SAMPLE_RATE );
+        aData[k] = getSignalValue( aSignalsVector, time );
+    }
+}
+
+
+//!************************************************************************
+//! Accumulate the errors of an optimised output against the reference
+//!
+//! @returns: nothing
+//!************************************************************************
+static void compare
+    (
+    const std::vector<double>&  aRef,           //!< reference samples
+    const std::vector<double>&  aOpt,           //!< optimised samples
+    ErrorStats&                 aStats          //!< accumulated errors
+    )
+{
+    for( size_t i = 0; i < aRef.size(); i++ )
+    {
+        const double error = fabs( aOpt[i] - aRef[i] );
+
+        aStats.maxAbs = std::max( aStats.maxAbs, std::isnan( error ) ? INFINITY : error );
+        aStats.sumSquares += error * error;
+    }
+
+    aStats.count += aRef.size();
+}
+
+
+//!************************************************************************
+//! Estimate the delay of an optimised output against the reference
+//! For a small delay d, opt(t) ~ ref(t) - d * ref'(t), so d is fitted
+//! by least squares over the derivative of the reference.
+//!
+//! @returns: the delay [ns], 0 if the reference is flat
+//!************************************************************************
+static double estimateDriftNs
+    (
+    const std::vector<double>&  aRef,           //!< reference samples
+    const std::vector<double>&  aOpt            //!< optimised samples
+    )
+{
+    double sumProducts = 0;
+    double sumSquares = 0;
+
+    for( size_t i = 1; i + 1 < aRef.size(); i++ )
+    {
+        const double slope = 0.5 * ( aRef[i + 1] - aRef[i - 1] ) * SAMPLE_RATE;
+
+        sumProducts += ( aRef[i] - aOpt[i] ) * slope;
+        sumSquares += slope * slope;
+    }
+
+    return ( sumSquares > 1e-12 * aRef.size() ) ? 1e9 * fabs( sumProducts / sumSquares ) : 0;
+}
+
+
+//!************************************************************************
+//! Create a deterministic signal item with random parameters
+//!
+//! @returns: the signal item
+//!************************************************************************
+static SignalItem randomItem
+    (
+    const SignalItem::SignalType    aType,      //!< signal type
+    std::mt19937&                   aRng        //!< random generator
+    )
+{
+    std::uniform_real_distribution<double> unit( 0, 1 );
+    auto uniform = [&]( double aMin, double aMax ) { return aMin + ( aMax - aMin ) * unit( aRng ); };
+    auto logUniform = [&]( double aMin, double aMax ) { return aMin * pow( aMax / aMin, unit( aRng ) ); };
+
+    switch( aType )
+    {
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:
+            {
+                SignalItem::SignalRectangle sig;
+                sig.tPeriod = logUniform( MIN_PERIOD_S, MAX_PERIOD_S );
+                sig.fillFactor = uniform( 0.1, 0.9 );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.yMax = uniform( 0, 1 );
+                sig.yMin = -uniform( 0, 1 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_PULSE:
+            {
+                SignalItem::SignalPulse sig;
+                sig.tPeriod = logUniform( MIN_PERIOD_S, MAX_PERIOD_S );
+                sig.tRise = sig.tPeriod * uniform( 0.05, 0.3 );
+                sig.tWidth = sig.tPeriod * uniform( 0.1, 0.4 );
+                sig.tFall = sig.tPeriod * uniform( 0.05, 0.3 );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.yMax = uniform( 0, 1 );
+                sig.yMin = -uniform( 0, 1 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_RISEFALL:
+            {
+                SignalItem::SignalRiseFall sig;
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.tDelayRise = uniform( 0.1, 0.4 );
+                sig.tRampRise = uniform( 0.01, 0.2 );
+                sig.tDelayFall = uniform( 0.5, 0.9 );
+                sig.tRampFall = uniform( 0.01, 0.2 );
+                sig.yMax = uniform( 0, 1 );
+                sig.yMin = -uniform( 0, 1 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_SINDAMP:
+            {
+                SignalItem::SignalSinDamp sig;
+                sig.freqHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.phiRad = uniform( 0, 2 * M_PI );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.amplit = uniform( 0, 0.5 );
+                sig.offset = uniform( -0.5, 0.5 );
+                sig.damping = uniform( 0, 2 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_SINRISE:
+            {
+                SignalItem::SignalSinRise sig;
+                sig.freqHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.phiRad = uniform( 0, 2 * M_PI );
+                sig.tEnd = uniform( 0.5, 0.9 );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.amplit = uniform( 0, 0.5 );
+                sig.offset = uniform( -0.5, 0.5 );
+                sig.damping = uniform( 0, 2 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_WAVSIN:
+            {
+                SignalItem::SignalWavSin sig;
+                sig.freqHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.phiRad = uniform( 0, 2 * M_PI );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.amplit = uniform( 0, 0.5 );
+                sig.offset = uniform( -0.5, 0.5 );
+                sig.index = static_cast<uint8_t>( 3 + 2 * static_cast<int>( uniform( 0, 15 ) ) );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_AMSIN:
+            {
+                SignalItem::SignalAmSin sig;
+                sig.carrierFreqHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.carrierAmplitude = uniform( 0, 0.25 );
+                sig.carrierOffset = uniform( -0.5, 0.5 );
+                sig.carrierTDelay = uniform( 0, 0.1 );
+                sig.modulationFreqHz = logUniform( 0.1, 100 );
+                sig.modulationPhiRad = uniform( 0, 2 * M_PI );
+                sig.modulationIndex = uniform( 0, 1 );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+            {
+                // growing envelopes (negative damping types) are left out,
+                // they leave the budgets meaningless after an hour
+                SignalItem::SignalSinDampSin sig;
+                sig.freqSinHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.tPeriodEnv = logUniform( 0.01, MAX_PERIOD_S );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.amplit = uniform( 0, 0.5 );
+                sig.offset = uniform( -0.5, 0.5 );
+                sig.dampingType = static_cast<int8_t>( uniform( 0, 4 ) );
+                return SignalItem( sig );
+            }
+
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+            {
+                SignalItem::SignalTrapDampSin sig;
+                sig.tPeriod = logUniform( 0.01, MAX_PERIOD_S );
+                sig.tRise = sig.tPeriod * uniform( 0.05, 0.3 );
+                sig.tWidth = sig.tPeriod * uniform( 0.1, 0.4 );
+                sig.tFall = sig.tPeriod * uniform( 0.05, 0.3 );
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.tCross = uniform( 1, 20 );
+                sig.freqHz = logUniform( MIN_FREQ_HZ, MAX_FREQ_HZ );
+                sig.amplit = uniform( 0, 0.5 );
+                sig.offset = uniform( -0.5, 0.5 );
+                return SignalItem( sig );
+            }
+
+        default:
+            {
+                SignalItem::SignalTriangle sig;
+                sig.tPeriod = logUniform( MIN_PERIOD_S, MAX_PERIOD_S );
+                sig.tRise = sig.tPeriod * uniform( 0.05, 0.95 );
+                sig.tFall = sig.tPeriod - sig.tRise;
+                sig.tDelay = uniform( 0, 0.1 );
+                sig.yMax = uniform( 0, 1 );
+                sig.yMin = -uniform( 0, 1 );
+                return SignalItem( sig );
+            }
+    }
+}
+
+
+//!************************************************************************
+//! Create a noise item with random parameters
+//!
+//! @returns: the signal item
+//!************************************************************************
+static SignalItem randomNoiseItem
+    (
+    const double        aGamma,     //!< frequency exponent
+    std::mt19937&       aRng        //!< random generator
+    )
+{
+    std::uniform_real_distribution<double> unit( 0, 1 );
+
+    SignalItem::SignalNoise sig;
+    sig.noiseType = static_cast<SignalItem::NoiseType>( SignalItem::NOISE_TYPE_DEK + static_cast<int>( 3 * unit( aRng ) ) % 3 );
+    sig.gamma = aGamma;
+    sig.tDelay = 0.1 * unit( aRng );
+    sig.amplit = 0.1 + 0.4 * unit( aRng );
+    sig.offset = 0.2 * unit( aRng ) - 0.1;
+
+    return SignalItem( sig );
+}
+
+
+//!************************************************************************
+//! Render a window from the current position of the engine, in blocks
+//!
+//! @returns: time spent [ns]
+//!************************************************************************
+static double renderBlocks
+    (
+    RenderEngine&           aEngine,        //!< render engine
+    std::vector<double>&    aData           //!< output samples
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point t0 = Clock::now();
+
+    for( size_t i = 0; i < aData.size(); i += BLOCK_SIZE )
+    {
+        aEngine.render( aData.data() + i, std::min( BLOCK_SIZE, aData.size() - i ) );
+    }
+
+    return std::chrono::duration<double, std::nano>( Clock::now() - t0 ).count();
+}
+
+
+//!************************************************************************
+//! Compare the render paths of one item against its reference
+//! For noise items, the reference is a single render of the window and
+//! the seeks stay within the window.
+//!
+//! @returns: nothing
+//!************************************************************************
+static void checkItem
+    (
+    SignalItem&         aItem,          //!< signal item
+    std::mt19937&       aRng,           //!< random generator of the seek positions
+    ErrorStats&         aStats          //!< accumulated errors
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    const bool isNoise = ( SignalItem::SIGNAL_TYPE_NOISE == aItem.getType() );
+    std::vector<SignalItem*> signalsVector = { &aItem };
+    RenderEngine engine( SAMPLE_RATE, ENGINE_SEED );
+    engine.setData( signalsVector );
+
+    // from the start
+    std::vector<double> ref( WINDOW_SAMPLES );
+    std::vector<double> opt( WINDOW_SAMPLES );
+
+    Clock::time_point t0 = Clock::now();
+
+    if( isNoise )
+    {
+        engine.render( ref.data(), ref.size() );
+    }
+    else
+    {
+        renderReference( signalsVector, 0, ref.data(), ref.size() );
+    }
+
+    aStats.refNs += std::chrono::duration<double, std::nano>( Clock::now() - t0 ).count();
+
+    engine.reset();
+    aStats.optNs += renderBlocks( engine, opt );
+    aStats.timedSamples += WINDOW_SAMPLES;
+
+    compare( ref, opt, aStats );
+
+    // after seeks
+    const uint64_t seekRange = isNoise ? WINDOW_SAMPLES - SEEK_SAMPLES : static_cast<uint64_t>( SEEK_RANGE_SECONDS ) * SAMPLE_RATE;
+    std::uniform_int_distribution<uint64_t> seekPosition( 0, seekRange );
+    std::vector<double> seekRef( SEEK_SAMPLES );
+    std::vector<double> seekOpt( SEEK_SAMPLES );
+
+    for( int s = 0; s <= NR_OF_SEEKS; s++ )
+    {
+        // the last seek goes one hour ahead, for the drift
+        const bool isDriftSeek = ( NR_OF_SEEKS == s );
+
+        if( isDriftSeek && isNoise )
+        {
+            break;
+        }
+
+        uint64_t position = isDriftSeek ? static_cast<uint64_t>( DRIFT_SECONDS ) * SAMPLE_RATE : seekPosition( aRng );
+        position -= position % RenderEngine::CHUNK_ALIGNMENT;
+
+        engine.seek( position );
+        renderBlocks( engine, seekOpt );
+
+        if( isNoise )
+        {
+            std::copy( ref.begin() + position, ref.begin() + position + SEEK_SAMPLES, seekRef.begin() );
+        }
+        else
+        {
+            renderReference( signalsVector, position, seekRef.data(), seekRef.size() );
+        }
+
+        compare( seekRef, seekOpt, aStats );
+
+        if( isDriftSeek )
+        {
+            aStats.maxDriftNs = std::max( aStats.maxDriftNs, estimateDriftNs( seekRef, seekOpt ) );
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Compare a noise item with a non-default filter design, read from a
+//! text and a binary preset, against its white noise filtered by a
+//! NoisePwrSpectrum of the same design
+//! The design must survive both preset formats, and the output must
+//! differ from the one of the default design.
+//!
+//! @returns: nothing
+//!************************************************************************
+static void checkDesign
+    (
+    ErrorStats&         aStats          //!< accumulated errors
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int NR_OF_BLOCKS = 11;
+    const double POLE_DENSITY = 2;
+    const double GAMMA = 1;
+
+    const std::filesystem::path textName = std::filesystem::temp_directory_path() / "KernelCheckDesign.txt";
+    const std::filesystem::path binaryName = std::filesystem::temp_directory_path() / ( "KernelCheckDesign" + PresetFile::BINARY_EXTENSION );
+
+    {
+        // GAUSS noise of gamma 1, 11 blocks, 2 poles / decade
+        std::ofstream textFile( textName );
+        textFile << static_cast<int>( SignalItem::SIGNAL_TYPE_NOISE ) << ", 2, 1, 0, 0.2, 0, " << NR_OF_BLOCKS << ", " << POLE_DENSITY << "\n";
+    }
+
+    std::vector<SignalItem*> textVector;
+    std::vector<SignalItem*> binaryVector;
+
+    PresetFile::read( textName.string(), textVector );
+    PresetFile::writeBinary( binaryName.string(), textVector );
+    PresetFile::read( binaryName.string(), binaryVector );
+
+    std::filesystem::remove( textName );
+    std::filesystem::remove( binaryName );
+
+    bool isRead = ( 1 == textVector.size() && 1 == binaryVector.size() );
+
+    for( const auto& crtVector : { textVector, binaryVector } )
+    {
+        isRead = isRead
+              && SignalItem::SIGNAL_TYPE_NOISE == crtVector[0]->getType()
+              && NR_OF_BLOCKS == crtVector[0]->getSignalDataNoise().nrOfBlocks
+              && POLE_DENSITY == crtVector[0]->getSignalDataNoise().poleDensity
+              && GAMMA == crtVector[0]->getSignalDataNoise().gamma;
+    }
+
+    if( !isRead )
+    {
+        aStats.maxAbs = INFINITY;
+    }
+    else
+    {
+        std::vector<double> white( WINDOW_SAMPLES );
+        std::vector<double> ref( WINDOW_SAMPLES );
+        std::vector<double> opt( WINDOW_SAMPLES );
+
+        SignalItem::SignalNoise whiteSig = binaryVector[0]->getSignalDataNoise();
+        whiteSig.gamma = 0;
+        SignalItem whiteItem( whiteSig );
+        std::vector<SignalItem*> whiteVector = { &whiteItem };
+
+        RenderEngine whiteEngine( SAMPLE_RATE, ENGINE_SEED );
+        whiteEngine.setData( whiteVector );
+        whiteEngine.render( white.data(), white.size() );
+
+        Clock::time_point t0 = Clock::now();
+        NoisePwrSpectrum( GAMMA, SAMPLE_RATE, NR_OF_BLOCKS, POLE_DENSITY ).filterData( white, ref );
+        aStats.refNs += std::chrono::duration<double, std::nano>( Clock::now() - t0 ).count();
+
+        RenderEngine engine( SAMPLE_RATE, ENGINE_SEED );
+        engine.setData( binaryVector );
+        aStats.optNs += renderBlocks( engine, opt );
+        aStats.timedSamples += WINDOW_SAMPLES;
+
+        compare( ref, opt, aStats );
+
+        // the default design (here the pink noise engine) must give another output
+        SignalItem::SignalNoise defaultSig = whiteSig;
+        defaultSig.gamma = GAMMA;
+        defaultSig.nrOfBlocks = NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS;
+        defaultSig.poleDensity = NoisePwrSpectrum::DEFAULT_POLE_DENSITY;
+        SignalItem defaultItem( defaultSig );
+        std::vector<SignalItem*> defaultVector = { &defaultItem };
+        std::vector<double> defaultOpt( WINDOW_SAMPLES );
+
+        RenderEngine defaultEngine( SAMPLE_RATE, ENGINE_SEED );
+        defaultEngine.setData( defaultVector );
+        renderBlocks( defaultEngine, defaultOpt );
+
+        ErrorStats defaultStats;
+        compare( defaultOpt, opt, defaultStats );
+
+        if( defaultStats.maxAbs < 1e-3 )
+        {
+            aStats.maxAbs = INFINITY;
+        }
+    }
+
+    for( auto& crtSignal : textVector )
+    {
+        delete crtSignal;
+    }
+
+    for( auto& crtSignal : binaryVector )
+    {
+        delete crtSignal;
+    }
+}
+
+
+//!************************************************************************
+//! Compare noise items of several gammas filtered together in lanes
+//! against the sum of the same items rendered one by one
+//!
+//! @returns: nothing
+//!************************************************************************
+static void checkLanes
+    (
+    std::mt19937&       aRng,           //!< random generator
+    ErrorStats&         aStats          //!< accumulated errors
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    // gamma = 1 goes to the pink noise engine, not to the lanes
+    const double GAMMA_VEC[] = { -1.5, -0.5, 0.5, 1.5, 2 };
+
+    std::vector<SignalItem> itemVec;
+
+    for( const double gamma : GAMMA_VEC )
+    {
+        itemVec.push_back( randomNoiseItem( gamma, aRng ) );
+    }
+
+    std::vector<double> ref( WINDOW_SAMPLES );
+    std::vector<double> opt( WINDOW_SAMPLES );
+    std::vector<double> single( WINDOW_SAMPLES );
+
+    // the seed of item k in a multi-item engine is the engine seed + k
+    for( size_t k = 0; k < itemVec.size(); k++ )
+    {
+        std::vector<SignalItem*> signalsVector = { &itemVec[k] };
+        RenderEngine engine( SAMPLE_RATE, ENGINE_SEED + static_cast<uint32_t>( k ) );
+        engine.setData( signalsVector );
+
+        aStats.refNs += renderBlocks( engine, single );
+
+        for( size_t i = 0; i < WINDOW_SAMPLES; i++ )
+        {
+            ref[i] += single[i];
+        }
+    }
+
+    std::vector<SignalItem*> signalsVector;
+
+    for( auto& crtItem : itemVec )
+    {
+        signalsVector.push_back( &crtItem );
+    }
+
+    RenderEngine engine( SAMPLE_RATE, ENGINE_SEED );
+    engine.setData( signalsVector );
+
+    const Clock::time_point t0 = Clock::now();
+    renderBlocks( engine, opt );
+    aStats.optNs += std::chrono::duration<double, std::nano>( Clock::now() - t0 ).count();
+    aStats.timedSamples += WINDOW_SAMPLES;
+
+    compare( ref, opt, aStats );
+}
+
+
+//!************************************************************************
+//! Report the errors of one type against its budget
+//!
+//! @returns: true if the type is within its budget
+//!************************************************************************
+static bool report
+    (
+    const std::string&      aName,          //!< name of the type
+    const ErrorStats&       aStats,         //!< accumulated errors
+    const ErrorBudget&      aBudget         //!< budget of the type
+    )
+{
+    const double rms = sqrt( aStats.sumSquares / std::max( 1.0, aStats.count ) );
+    const bool passed = ( aStats.maxAbs <= aBudget.maxAbs )
+                     && ( rms <= aBudget.rms )
+                     && ( aStats.maxDriftNs <= aBudget.driftNs );
+
+    printf( "%-12s %10.3g %10.3g %10.3g %10.2f %10.2f %8.2f  %s\n",
+            aName.c_str(), aStats.maxAbs, rms, aStats.maxDriftNs,
+            aStats.refNs / aStats.timedSamples, aStats.optNs / aStats.timedSamples,
+            aStats.refNs / aStats.optNs,
+            passed ? "ok" : "FAIL" );
+
+    return passed;
+}
+
+
+//!************************************************************************
+//! Main application
+//!
+//! @returns: 0 if all types are within their budgets, 1 otherwise
+//!************************************************************************
+int main
+    (
+    int     argc,
+    char*   argv[]
+    )
+{
+    const int nrOfSets = ( argc > 1 ) ? std::max( 1, atoi( argv[1] ) ) : DEFAULT_PARAMETER_SETS;
+    const uint32_t seed = ( argc > 2 ) ? static_cast<uint32_t>( strtoul( argv[2], nullptr, 10 ) ) : DEFAULT_SEED;
+
+    static const char* const TYPE_NAME_VEC[] =
+    {
+        "triangle", "rectangle", "pulse", "risefall", "sindamp",
+        "sinrise", "wavsin", "amsin", "sindampsin", "trapdampsin"
+    };
+
+    printf( "%d parameter sets per type, seed %u, drift after %u s\n\n", nrOfSets, seed, DRIFT_SECONDS );
+    printf( "type            max-abs        rms  drift[ns]  ref[ns/s]  opt[ns/s]  speedup  status\n" );
+
+    std::mt19937 rng( seed );
+    bool passed = true;
+
+    for( int t = SignalItem::SIGNAL_TYPE_FIRST; t < SignalItem::SIGNAL_TYPE_NOISE; t++ )
+    {
+        const SignalItem::SignalType type = static_cast<SignalItem::SignalType>( t );
+        const bool isSmooth = ( SignalItem::SIGNAL_TYPE_SINDAMP <= type && SignalItem::SIGNAL_TYPE_SINDAMPSIN >= type );
+        ErrorStats stats;
+
+        for( int p = 0; p < nrOfSets; p++ )
+        {
+            SignalItem item = randomItem( type, rng );
+            checkItem( item, rng, stats );
+        }
+
+        passed &= report( TYPE_NAME_VEC[t - SignalItem::SIGNAL_TYPE_FIRST], stats, isSmooth ? SMOOTH_BUDGET : PIECEWISE_BUDGET );
+    }
+
+    {
+        const double GAMMA_VEC[] = { 0, -1, 0.5, 1, 2 };
+        ErrorStats stats;
+
+        for( int p = 0; p < nrOfSets; p++ )
+        {
+            SignalItem item = randomNoiseItem( GAMMA_VEC[p % 5], rng );
+            checkItem( item, rng, stats );
+        }
+
+        passed &= report( "noise", stats, NOISE_BUDGET );
+    }
+
+    {
+        ErrorStats stats;
+
+        for( int p = 0; p < nrOfSets; p++ )
+        {
+            checkLanes( rng, stats );
+        }
+
+        passed &= report( "noise_lanes", stats, NOISE_BUDGET );
+    }
+
+    {
+        ErrorStats stats;
+        checkDesign( stats );
+
+        passed &= report( "noise_design", stats, NOISE_BUDGET );
+    }
+
+    return passed ? 0 : 1;
+}
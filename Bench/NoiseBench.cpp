@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+NoiseBench.cpp
+This file contains the headless benchmark qualifying the noise engines
+on both speed and spectral accuracy.
+
+For a sweep of gamma values, long Gaussian white noise sequences are
+coloured by each engine, the power spectral density of the output is
+estimated with Welch averaging and the dB/decade slope is fitted over
+[FIT_FREQ_MIN_HZ..FIT_FREQ_MAX_HZ]. The ideal slope is -10 * gamma.
+The IIR filter of NoisePwrSpectrum is the reference engine; the other
+engines qualify if their slope stays within MAX_SLOPE_DEVIATION_DB of it.
+
+Usage: NoiseBench [seconds] [sample rate]
+The exit code is nonzero if any engine fails to qualify.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "NoiseGenerator.h"
+#include "NoisePwrSpectrum.h"
+#include "PinkNoise.h"
+
+
+static const size_t WELCH_SEGMENT_SIZE = 8192;          //!< FFT length of a Welch segment (power of 2)
+static const double FIT_FREQ_MIN_HZ = 200;              //!< lower edge of the slope fit band
+static const double FIT_FREQ_MAX_HZ = 8000;             //!< upper edge of the slope fit band
+static const double MAX_SLOPE_DEVIATION_DB = 1.0;       //!< tolerated slope deviation from the reference [dB/decade]
+static const uint32_t NOISE_SEED = 1;                   //!< seed of the white noise input
+
+static const uint32_t DEFAULT_SECONDS = 60;             //!< default length of a rendered sequence
+
+
+//!************************************************************************
+//! In-place iterative radix-2 FFT
+//!
+//! @returns: nothing
+//!************************************************************************
+static void fft
+    (
+    std::vector<std::complex<double>>&  aData       //!< data, size a power of 2
+    )
+{
+    const size_t n = aData.size();
+
+    for( size_t i = 1, j = 0; i < n; i++ )
+    {
+        size_t bit = n >> 1;
+
+        for( ; j & bit; bit >>= 1 )
+        {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if( i < j )
+        {
+            std::swap( aData[i], aData[j] );
+        }
+    }
+
+    for( size_t len = 2; len <= n; len <<= 1 )
+    {
+        const std::complex<double> wLen = std::polar( 1.0, -2.0 * M_PI / len );
+
+        for( size_t i = 0; i < n; i += len )
+        {
+            std::complex<double> w = 1;
+
+            for( size_t j = 0; j < len / 2; j++ )
+            {
+                const std::complex<double> u = aData[i + j];
+                const std::complex<double> v = aData[i + j + len / 2] * w;
+                aData[i + j] = u + v;
+                aData[i + j + len / 2] = u - v;
+                w *= wLen;
+            }
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Estimate the power spectral density with Welch averaging
+//! (Hann window, 50% overlap)
+//!
+//! @returns: the PSD for bins 0..WELCH_SEGMENT_SIZE/2, arbitrary scale
+//!************************************************************************
+static std::vector<double> estimatePsd
+    (
+    const std::vector<double>&  aSignal     //!< signal
+    )
+{
+    std::vector<double> window( WELCH_SEGMENT_SIZE );
+
+    for( size_t i = 0; i < WELCH_SEGMENT_SIZE; i++ )
+    {
+        window[i] = 0.5 - 0.5 * cos( 2.0 * M_PI * i / WELCH_SEGMENT_SIZE );
+    }
+
+    std::vector<double> psd( WELCH_SEGMENT_SIZE / 2 + 1 );
+    std::vector<std::complex<double>> segment( WELCH_SEGMENT_SIZE );
+    size_t nrSegments = 0;
+
+    for( size_t start = 0; start + WELCH_SEGMENT_SIZE <= aSignal.size(); start += WELCH_SEGMENT_SIZE / 2 )
+    {
+        for( size_t i = 0; i < WELCH_SEGMENT_SIZE; i++ )
+        {
+            segment[i] = window[i] * aSignal[start + i];
+        }
+
+        fft( segment );
+
+        for( size_t k = 0; k < psd.size(); k++ )
+        {
+            psd[k] += std::norm( segment[k] );
+        }
+
+        nrSegments++;
+    }
+
+    for( auto& value : psd )
+    {
+        value /= std::max<size_t>( nrSegments, 1 );
+    }
+
+    return psd;
+}
+
+
+//!************************************************************************
+//! Fit the slope of the PSD in dB/decade over the fit band
+//! Bins are weighted by 1/f, so that every decade has the same weight.
+//!
+//! @returns: the slope [dB/decade]
+//!************************************************************************
+static double fitSlope
+    (
+    const std::vector<double>&  aPsd,           //!< PSD from estimatePsd
+    const uint32_t              aSampleRate     //!< sample rate [Hz]
+    )
+{
+    double sw = 0;
+    double sx = 0;
+    double sy = 0;
+    double sxx = 0;
+    double sxy = 0;
+
+    for( size_t k = 1; k < aPsd.size(); k++ )
+    {
+        const double freq = static_cast<double>( k ) * aSampleRate / WELCH_SEGMENT_SIZE;
+
+        if( freq >= FIT_FREQ_MIN_HZ && freq <= FIT_FREQ_MAX_HZ )
+        {
+            const double w = 1.0 / freq;
+            const double x = log10( freq );
+            const double y = 10.0 * log10( aPsd[k] );
+
+            sw += w;
+            sx += w * x;
+            sy += w * y;
+            sxx += w * x * x;
+            sxy += w * x * y;
+        }
+    }
+
+    return ( sw * sxy - sx * sy ) / ( sw * sxx - sx * sx );
+}
+
+
+//!************************************************************************
+//! Report the result of one engine run
+//!
+//! @returns: the fitted slope [dB/decade]
+//!************************************************************************
+static double report
+    (
+    const std::string&          aEngine,        //!< engine name
+    const double                aGamma,         //!< frequency exponent
+    const std::vector<double>&  aSignal,        //!< coloured signal
+    const uint32_t              aSampleRate,    //!< sample rate [Hz]
+    const double                aSamples,       //!< number of samples produced
+    const double                aSeconds,       //!< time spent [s]
+    const double*               aRefSlope,      //!< slope of the reference engine, nullptr for the reference itself
+    bool&                       aPassed         //!< cleared if the engine does not qualify
+    )
+{
+    const double slope = fitSlope( estimatePsd( aSignal ), aSampleRate );
+    const double ideal = -10.0 * aGamma;
+    char status[32] = "reference";
+
+    if( aRefSlope )
+    {
+        const double deviation = slope - *aRefSlope;
+        const bool passed = ( fabs( deviation ) <= MAX_SLOPE_DEVIATION_DB );
+
+        snprintf( status, sizeof( status ), "%s (%+.2f vs ref)", passed ? "ok" : "FAIL", deviation );
+        aPassed &= passed;
+    }
+
+    printf( "%-6s %6.2f %10.2f %10.2f %8.2f %12.2f  %s\n",
+            aEngine.c_str(), aGamma, slope, ideal, slope - ideal,
+            aSamples / aSeconds / 1e6,
+            status );
+
+    return slope;
+}
+
+
+//!************************************************************************
+//! Main application
+//!
+//! @returns: 0 if all engines passed, 1 otherwise
+//!************************************************************************
+int main
+    (
+    int     argc,
+    char*   argv[]
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    const uint32_t seconds = ( argc > 1 ) ? std::max( 1, atoi( argv[1] ) ) : DEFAULT_SECONDS;
+    const uint32_t sampleRate = ( argc > 2 ) ? std::max( 1, atoi( argv[2] ) ) : NoisePwrSpectrum::DEFAULT_SAMPLE_RATE;
+    const size_t nrPoints = static_cast<size_t>( seconds ) * sampleRate;
+
+    std::vector<std::vector<double>> whiteVec( NoisePwrSpectrum::MAX_LANES, std::vector<double>( nrPoints ) );
+    std::vector<std::vector<double>> colouredVec( NoisePwrSpectrum::MAX_LANES, std::vector<double>( nrPoints ) );
+
+    Clock::time_point t0 = Clock::now();
+
+    for( size_t l = 0; l < whiteVec.size(); l++ )
+    {
+        NoiseGenerator noiseGenerator( NOISE_SEED + l );
+        noiseGenerator.fillGauss( whiteVec[l].data(), nrPoints );
+    }
+
+    double elapsed = std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+    printf( "%u s at %u Hz, %zu samples per stream\n", seconds, sampleRate, nrPoints );
+    printf( "gauss generator: %.2f Msamples/s\n\n", whiteVec.size() * nrPoints / elapsed / 1e6 );
+    printf( "engine  gamma  slope[dB]   ideal[dB]  err[dB]   Msamples/s  status\n" );
+
+    bool passed = true;
+
+    for( int g = -4; g <= 4; g++ )
+    {
+        const double gamma = 0.5 * g;
+
+        if( 0 == g )
+        {
+            continue;
+        }
+
+        // one IIR stream
+        NoisePwrSpectrum noisePwrSpectrum( gamma, sampleRate );
+
+        t0 = Clock::now();
+        noisePwrSpectrum.filterData( whiteVec[0], colouredVec[0] );
+        elapsed = std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+        const double refSlope = report( "iir", gamma, colouredVec[0], sampleRate, nrPoints, elapsed, nullptr, passed );
+
+        // independent IIR streams sharing lanes
+        std::vector<const NoisePwrSpectrum*> laneFilterVec( NoisePwrSpectrum::MAX_LANES, &noisePwrSpectrum );
+        std::vector<const std::vector<double>*> laneInVec;
+        std::vector<std::vector<double>*> laneOutVec;
+
+        for( size_t l = 0; l < NoisePwrSpectrum::MAX_LANES; l++ )
+        {
+            laneInVec.push_back( &whiteVec[l] );
+            laneOutVec.push_back( &colouredVec[l] );
+        }
+
+        t0 = Clock::now();
+        NoisePwrSpectrum::filterDataLanes( laneFilterVec, laneInVec, laneOutVec );
+        elapsed = std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+        report( "lanes", gamma, colouredVec[NoisePwrSpectrum::MAX_LANES - 1], sampleRate,
+                static_cast<double>( NoisePwrSpectrum::MAX_LANES ) * nrPoints, elapsed, &refSlope, passed );
+
+        // dedicated pink noise engine
+        if( PinkNoise::GAMMA == gamma )
+        {
+            PinkNoise pinkNoise( sampleRate );
+
+            t0 = Clock::now();
+            pinkNoise.filterData( whiteVec[0], colouredVec[0] );
+            elapsed = std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+            report( "pink", gamma, colouredVec[0], sampleRate, nrPoints, elapsed, &refSlope, passed );
+        }
+    }
+
+    return passed ? 0 : 1;
+}
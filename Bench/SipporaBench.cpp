@@ -0,0 +1,424 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SipporaBench.cpp
+This file contains the microbenchmarks of the signal kernels and of the
+render pipeline stages.
+
+Every case is run once to warm up, then REPETITIONS times; the minimum
+and the median time per processed unit (sample or call) are reported,
+and the throughput of the median run in units per second.
+The deterministic signal kernels are measured through RenderEngine with
+a single item of the given type and default parameters, which adds the
+per-sample loop of render() to the kernel itself.
+
+Usage: sippora_bench [repetitions] [json file]
+The results are written as JSON to the file, or to stdout.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "NoiseGenerator.h"
+#include "NoisePwrSpectrum.h"
+#include "PinkNoise.h"
+#include "RenderEngine.h"
+#include "RingBuffer.h"
+#include "SignalItem.h"
+
+
+static const uint32_t SAMPLE_RATE = 44100;              //!< sample rate of all cases [Hz]
+static const uint32_t SEED = 1;                         //!< seed of all random generators
+static const int DEFAULT_REPETITIONS = 5;               //!< default number of timed runs per case
+
+static const size_t KERNEL_SAMPLES = 1 << 19;           //!< samples rendered by the kernel cases
+static const size_t BLOCK_SIZE = 4096;                  //!< block size of the kernel and noise cases
+static const size_t RING_BLOCK_SIZE = 512;              //!< block copied through the ring, as read by the audio output
+static const int NR_OF_CONSTRUCTIONS = 8;               //!< noise filters constructed per construction run
+
+static const uint32_t RENDER_SECONDS_VEC[] = { 1, 10, 60 };     //!< lengths of the end to end renders [s]
+static const size_t RENDER_ITEMS_VEC[] = { 1, 4, 16 };          //!< numbers of items of the end to end renders
+
+struct BenchResult
+{
+    std::string     group;          //!< group of the case
+    std::string     name;           //!< name of the case
+    std::string     unit;           //!< processed unit, "sample" or "call"
+    double          units;          //!< units processed per run
+    double          minNs;          //!< fastest run [ns/unit]
+    double          medianNs;       //!< median run [ns/unit]
+};
+
+
+//!************************************************************************
+//! Create a signal item of the given type with default parameters
+//!
+//! @returns: the signal item
+//!************************************************************************
+static SignalItem createItem
+    (
+    const SignalItem::SignalType    aType,          //!< signal type
+    const SignalItem::NoiseType     aNoiseType,     //!< noise type, for SIGNAL_TYPE_NOISE
+    const double                    aGamma          //!< noise frequency exponent, for SIGNAL_TYPE_NOISE
+    )
+{
+    switch( aType )
+    {
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:     return SignalItem( SignalItem::SignalRectangle() );
+        case SignalItem::SIGNAL_TYPE_PULSE:         return SignalItem( SignalItem::SignalPulse() );
+        case SignalItem::SIGNAL_TYPE_RISEFALL:      return SignalItem( SignalItem::SignalRiseFall() );
+        case SignalItem::SIGNAL_TYPE_SINDAMP:       return SignalItem( SignalItem::SignalSinDamp() );
+        case SignalItem::SIGNAL_TYPE_SINRISE:       return SignalItem( SignalItem::SignalSinRise() );
+        case SignalItem::SIGNAL_TYPE_WAVSIN:        return SignalItem( SignalItem::SignalWavSin() );
+        case SignalItem::SIGNAL_TYPE_AMSIN:         return SignalItem( SignalItem::SignalAmSin() );
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:    return SignalItem( SignalItem::SignalSinDampSin() );
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:   return SignalItem( SignalItem::SignalTrapDampSin() );
+
+        case SignalItem::SIGNAL_TYPE_NOISE:
+            {
+                SignalItem::SignalNoise sig;
+                sig.noiseType = aNoiseType;
+                sig.gamma = aGamma;
+                return SignalItem( sig );
+            }
+
+        default:                                    return SignalItem( SignalItem::SignalTriangle() );
+    }
+}
+
+
+//!************************************************************************
+//! Time a case: one warm-up run, then aRepetitions timed runs
+//!
+//! @returns: the result of the case
+//!************************************************************************
+static BenchResult measure
+    (
+    const std::string&              aGroup,         //!< group of the case
+    const std::string&              aName,          //!< name of the case
+    const std::string&              aUnit,          //!< processed unit
+    const double                    aUnits,         //!< units processed per run
+    const int                       aRepetitions,   //!< number of timed runs
+    const std::function<void()>&    aRun            //!< one run of the case
+    )
+{
+    using Clock = std::chrono::steady_clock;
+
+    fprintf( stderr, "%s/%s\n", aGroup.c_str(), aName.c_str() );
+
+    aRun();
+
+    std::vector<double> nsVec;
+
+    for( int r = 0; r < aRepetitions; r++ )
+    {
+        const Clock::time_point t0 = Clock::now();
+        aRun();
+        nsVec.push_back( std::chrono::duration<double, std::nano>( Clock::now() - t0 ).count() / aUnits );
+    }
+
+    std::sort( nsVec.begin(), nsVec.end() );
+
+    return BenchResult{ aGroup, aName, aUnit, aUnits, nsVec.front(), nsVec.at( nsVec.size() / 2 ) };
+}
+
+
+//!************************************************************************
+//! Render a signal from its start in blocks
+//!
+//! @returns: nothing
+//!************************************************************************
+static void renderBlocks
+    (
+    RenderEngine&           aEngine,        //!< render engine, with its items set
+    std::vector<double>&    aData,          //!< output samples, one block
+    const uint64_t          aNrOfSamples    //!< number of samples
+    )
+{
+    aEngine.reset();
+
+    for( uint64_t rendered = 0; rendered < aNrOfSamples; rendered += aData.size() )
+    {
+        aEngine.render( aData.data(), std::min<uint64_t>( aData.size(), aNrOfSamples - rendered ) );
+    }
+}
+
+
+//!************************************************************************
+//! Write the results as JSON
+//!
+//! @returns: nothing
+//!************************************************************************
+static void writeJson
+    (
+    FILE*                           aFile,          //!< output file
+    const std::vector<BenchResult>& aResultVec,     //!< results
+    const int                       aRepetitions    //!< number of timed runs per case
+    )
+{
+    fprintf( aFile, "{\n" );
+    fprintf( aFile, "  \"benchmark\": \"sippora_bench\",\n" );
+#ifdef __VERSION__
+    fprintf( aFile, "  \"compiler\": \"%s\",\n", __VERSION__ );
+#endif
+    fprintf( aFile, "  \"sample_rate\": %u,\n", SAMPLE_RATE );
+    fprintf( aFile, "  \"repetitions\": %d,\n", aRepetitions );
+    fprintf( aFile, "  \"results\": [\n" );
+
+    for( size_t i = 0; i < aResultVec.size(); i++ )
+    {
+        const BenchResult& crtResult = aResultVec[i];
+
+        fprintf( aFile, "    { \"group\": \"%s\", \"name\": \"%s\", \"unit\": \"%s\", \"units\": %.0f, \"min_ns\": %.3f, \"median_ns\": %.3f, \"per_second\": %.0f }%s\n",
+                 crtResult.group.c_str(), crtResult.name.c_str(), crtResult.unit.c_str(), crtResult.units,
+                 crtResult.minNs, crtResult.medianNs, 1e9 / crtResult.medianNs,
+                 ( i + 1 < aResultVec.size() ) ? "," : "" );
+    }
+
+    fprintf( aFile, "  ]\n" );
+    fprintf( aFile, "}\n" );
+}
+
+
+//!************************************************************************
+//! Main application
+//!
+//! @returns: 0 if the results were written, 1 otherwise
+//!************************************************************************
+int main
+    (
+    int     argc,
+    char*   argv[]
+    )
+{
+    const int repetitions = ( argc > 1 ) ? std::max( 1, atoi( argv[1] ) ) : DEFAULT_REPETITIONS;
+    std::vector<BenchResult> resultVec;
+
+    //**************************************
+    // deterministic signal kernels
+    //**************************************
+    static const char* const TYPE_NAME_VEC[] =
+    {
+        "triangle", "rectangle", "pulse", "risefall", "sindamp",
+        "sinrise", "wavsin", "amsin", "sindampsin", "trapdampsin"
+    };
+
+    std::vector<double> blockData( BLOCK_SIZE );
+
+    for( int t = SignalItem::SIGNAL_TYPE_FIRST; t < SignalItem::SIGNAL_TYPE_NOISE; t++ )
+    {
+        SignalItem item = createItem( static_cast<SignalItem::SignalType>( t ), SignalItem::NOISE_TYPE_DEK, 0 );
+        std::vector<SignalItem*> signalsVector = { &item };
+        RenderEngine engine( SAMPLE_RATE, SEED );
+        engine.setData( signalsVector );
+
+        resultVec.push_back( measure( "kernel", TYPE_NAME_VEC[t - SignalItem::SIGNAL_TYPE_FIRST], "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]() { renderBlocks( engine, blockData, KERNEL_SAMPLES ); } ) );
+    }
+
+    //**************************************
+    // noise generators
+    //**************************************
+    static const char* const NOISE_NAME_VEC[] = { "dek", "nag", "gauss" };
+
+    for( int n = SignalItem::NOISE_TYPE_DEK; n < SignalItem::NOISE_TYPE_COUNT; n++ )
+    {
+        SignalItem item = createItem( SignalItem::SIGNAL_TYPE_NOISE, static_cast<SignalItem::NoiseType>( n ), 0 );
+        std::vector<SignalItem*> signalsVector = { &item };
+        RenderEngine engine( SAMPLE_RATE, SEED );
+        engine.setData( signalsVector );
+
+        resultVec.push_back( measure( "noise", NOISE_NAME_VEC[n - SignalItem::NOISE_TYPE_DEK], "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]() { renderBlocks( engine, blockData, KERNEL_SAMPLES ); } ) );
+    }
+
+    {
+        NoiseGenerator noiseGenerator( SEED );
+
+        resultVec.push_back( measure( "noise", "gauss_block", "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]()
+                                      {
+                                          noiseGenerator.setPosition( 0 );
+
+                                          for( size_t i = 0; i < KERNEL_SAMPLES; i += BLOCK_SIZE )
+                                          {
+                                              noiseGenerator.fillGauss( blockData.data(), BLOCK_SIZE );
+                                          }
+                                      } ) );
+    }
+
+    //**************************************
+    // noise filters
+    //**************************************
+    {
+        // distinct gammas off the grid, cycling over more of them than the
+        // cache keeps, so every construction designs its filter and the
+        // cache stays bounded
+        const size_t NR_OF_GAMMAS = 2 * NoisePwrSpectrum::MAX_OFF_GRID_FILTERS;
+        size_t nrOfDesigns = 0;
+
+        resultVec.push_back( measure( "filter", "construct_design", "call", NR_OF_CONSTRUCTIONS, repetitions,
+                                      [&]()
+                                      {
+                                          for( int i = 0; i < NR_OF_CONSTRUCTIONS; i++ )
+                                          {
+                                              NoisePwrSpectrum noisePwrSpectrum( 0.10005 + 1e-4 * ( nrOfDesigns++ % NR_OF_GAMMAS ), SAMPLE_RATE );
+                                          }
+                                      } ) );
+
+        resultVec.push_back( measure( "filter", "construct_cached", "call", NR_OF_CONSTRUCTIONS, repetitions,
+                                      [&]()
+                                      {
+                                          for( int i = 0; i < NR_OF_CONSTRUCTIONS; i++ )
+                                          {
+                                              NoisePwrSpectrum noisePwrSpectrum( 1, SAMPLE_RATE );
+                                          }
+                                      } ) );
+    }
+
+    {
+        std::vector<std::vector<double>> whiteVec( NoisePwrSpectrum::MAX_LANES, std::vector<double>( KERNEL_SAMPLES ) );
+        std::vector<std::vector<double>> colouredVec( NoisePwrSpectrum::MAX_LANES, std::vector<double>( KERNEL_SAMPLES ) );
+
+        for( size_t l = 0; l < whiteVec.size(); l++ )
+        {
+            NoiseGenerator noiseGenerator( SEED + l );
+            noiseGenerator.fillGauss( whiteVec[l].data(), KERNEL_SAMPLES );
+        }
+
+        NoisePwrSpectrum noisePwrSpectrum( 1, SAMPLE_RATE );
+        PinkNoise pinkNoise( SAMPLE_RATE );
+
+        resultVec.push_back( measure( "filter", "iir", "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]() { noisePwrSpectrum.filterData( whiteVec[0], colouredVec[0] ); } ) );
+
+        std::vector<const NoisePwrSpectrum*> laneFilterVec( NoisePwrSpectrum::MAX_LANES, &noisePwrSpectrum );
+        std::vector<const std::vector<double>*> laneInVec;
+        std::vector<std::vector<double>*> laneOutVec;
+
+        for( size_t l = 0; l < NoisePwrSpectrum::MAX_LANES; l++ )
+        {
+            laneInVec.push_back( &whiteVec[l] );
+            laneOutVec.push_back( &colouredVec[l] );
+        }
+
+        resultVec.push_back( measure( "filter", "iir_lanes", "sample", static_cast<double>( NoisePwrSpectrum::MAX_LANES ) * KERNEL_SAMPLES, repetitions,
+                                      [&]() { NoisePwrSpectrum::filterDataLanes( laneFilterVec, laneInVec, laneOutVec ); } ) );
+
+        resultVec.push_back( measure( "filter", "pink", "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]()
+                                      {
+                                          pinkNoise.reset();
+                                          pinkNoise.filterData( whiteVec[0], colouredVec[0] );
+                                      } ) );
+    }
+
+    //**************************************
+    // output stages
+    //**************************************
+    {
+        std::vector<double> data( KERNEL_SAMPLES );
+        std::vector<int16_t> samples( KERNEL_SAMPLES );
+        NoiseGenerator noiseGenerator( SEED );
+        noiseGenerator.fillGauss( data.data(), data.size() );
+
+        resultVec.push_back( measure( "stage", "quantize", "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]() { RenderEngine::quantize( data.data(), samples.data(), samples.size() ); } ) );
+
+        // the render thread writes blocks, readData() copies them out
+        RingBuffer ringBuffer( 4 * RING_BLOCK_SIZE );
+
+        resultVec.push_back( measure( "stage", "ring_copy", "sample", KERNEL_SAMPLES, repetitions,
+                                      [&]()
+                                      {
+                                          for( size_t i = 0; i < KERNEL_SAMPLES; i += RING_BLOCK_SIZE )
+                                          {
+                                              ringBuffer.write( samples.data() + i, RING_BLOCK_SIZE );
+                                              ringBuffer.read( samples.data() + i, RING_BLOCK_SIZE );
+                                          }
+                                      } ) );
+    }
+
+    //**************************************
+    // end to end renders, as in playback: render and quantize
+    //**************************************
+    for( const size_t nrOfItems : RENDER_ITEMS_VEC )
+    {
+        // deterministic types in turn, every fourth item a pink Gaussian noise
+        std::vector<SignalItem> itemVec;
+
+        for( size_t i = 0; i < nrOfItems; i++ )
+        {
+            if( 3 == i % 4 )
+            {
+                itemVec.push_back( createItem( SignalItem::SIGNAL_TYPE_NOISE, SignalItem::NOISE_TYPE_GAUSS, 1 ) );
+            }
+            else
+            {
+                itemVec.push_back( createItem( static_cast<SignalItem::SignalType>( SignalItem::SIGNAL_TYPE_FIRST + i % 10 ), SignalItem::NOISE_TYPE_DEK, 0 ) );
+            }
+        }
+
+        std::vector<SignalItem*> signalsVector;
+
+        for( auto& crtItem : itemVec )
+        {
+            signalsVector.push_back( &crtItem );
+        }
+
+        RenderEngine engine( SAMPLE_RATE, SEED );
+        engine.setData( signalsVector );
+
+        for( const uint32_t seconds : RENDER_SECONDS_VEC )
+        {
+            const uint64_t nrOfSamples = static_cast<uint64_t>( seconds ) * SAMPLE_RATE;
+            std::vector<double> data( std::min<uint64_t>( RenderEngine::DEFAULT_CHUNK_SIZE, nrOfSamples ) );
+            std::vector<int16_t> samples( data.size() );
+
+            resultVec.push_back( measure( "render", std::to_string( nrOfItems ) + "_items_" + std::to_string( seconds ) + "_s", "sample", nrOfSamples, repetitions,
+                                          [&]()
+                                          {
+                                              engine.reset();
+
+                                              for( uint64_t rendered = 0; rendered < nrOfSamples; rendered += data.size() )
+                                              {
+                                                  const size_t count = std::min<uint64_t>( data.size(), nrOfSamples - rendered );
+                                                  engine.render( data.data(), count );
+                                                  RenderEngine::quantize( data.data(), samples.data(), count );
+                                              }
+                                          } ) );
+        }
+    }
+
+    FILE* file = ( argc > 2 ) ? fopen( argv[2], "w" ) : stdout;
+
+    if( !file )
+    {
+        fprintf( stderr, "cannot write %s\n", argv[2] );
+        return 1;
+    }
+
+    writeJson( file, resultVec, repetitions );
+
+    return ( stdout == file || 0 == fclose( file ) ) ? 0 : 1;
+}
@@ -0,0 +1,652 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+CommandLine.cpp
+This file contains the sources for the command line (headless) mode.
+*/
+
+#include "CommandLine.h"
+
+#if defined( _WIN32 )
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <spawn.h>
+    #include <sys/wait.h>
+
+    extern char** environ;
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "BatchRenderer.h"
+#include "NoisePwrSpectrum.h"
+#include "PresetFile.h"
+#include "RenderCache.h"
+#include "RenderEngine.h"
+#include "WavWriter.h"
+
+
+//!************************************************************************
+//! Check if the command line mode is requested
+//!
+//! @returns: true if any argument is a command line option
+//!************************************************************************
+bool CommandLine::isRequested
+    (
+    int     argc,           //!< number of arguments
+    char*   argv[]          //!< arguments
+    )
+{
+    bool requested = false;
+
+    for( int i = 1; i < argc && !requested; i++ )
+    {
+        requested = ( 0 == strcmp( argv[i], "--render" ) || 0 == strcmp( argv[i], "--batch" ) || 0 == strcmp( argv[i], "--help" ) );
+    }
+
+    return requested;
+}
+
+
+//!************************************************************************
+//! Parse a finite decimal number, independently of the current locale
+//!
+//! @returns: true if the whole string is a number
+//!************************************************************************
+bool CommandLine::parseDouble
+    (
+    const std::string&  aString,    //!< string
+    double&             aValue      //!< value
+    )
+{
+    double value = 0;
+    const std::from_chars_result result = std::from_chars( aString.data(), aString.data() + aString.size(), value );
+    const bool status = ( !aString.empty() && std::errc() == result.ec && aString.data() + aString.size() == result.ptr && std::isfinite( value ) );
+
+    if( status )
+    {
+        aValue = value;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Parse an unsigned decimal number
+//!
+//! @returns: true if the whole string is a number
+//!************************************************************************
+bool CommandLine::parseUnsigned
+    (
+    const std::string&  aString,    //!< string
+    uint64_t&           aValue      //!< value
+    )
+{
+    bool status = !aString.empty() && aString.size() < 20;
+    uint64_t value = 0;
+
+    for( size_t i = 0; status && i < aString.size(); i++ )
+    {
+        status = ( aString[i] >= '0' && aString[i] <= '9' );
+        value = 10 * value + ( aString[i] - '0' );
+    }
+
+    if( status )
+    {
+        aValue = value;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Print the usage of the command line mode
+//!
+//! @returns: nothing
+//!************************************************************************
+void CommandLine::printUsage
+    (
+    FILE*   aStream         //!< output stream
+    )
+{
+    fprintf( aStream,
+             "Usage: Sippora --render <preset.txt> --out <file.wav> [options]\n"
+             "       Sippora --batch <directory|list.txt> [--outdir <directory>] [options]\n"
+             "  --seconds <n>   length of the render [s], 1..%u, default %u\n"
+             "  --rate <Hz>     sample rate, %u..%u, default %u\n"
+             "  --seed <n>      seed of the noise generators, default derived from the preset\n"
+             "  --blocks <n>    number of noise filter blocks, %d..%d, default from the preset\n"
+             "  --poles <x>     noise filter poles per decade, %g..%g, default from the preset\n"
+             "  --start <n>     index of the first sample, multiple of %zu, default 0\n"
+             "  --samples <n>   number of samples, instead of --seconds\n"
+             "  --processes <n> split the render between n worker processes, 1..%u, default 1\n"
+             "  --threads <n>   threads used for filtering noise, default one per core\n"
+             "  --jobs <n>      batch: concurrent renders, default one per core\n"
+             "  --memory <MB>   batch: memory budget of the running renders, default unlimited\n",
+             MAX_SECONDS, DEFAULT_SECONDS, MIN_SAMPLE_RATE, MAX_SAMPLE_RATE, DEFAULT_SAMPLE_RATE,
+             NoisePwrSpectrum::MIN_NR_OF_FILTER_BLOCKS, NoisePwrSpectrum::MAX_NR_OF_FILTER_BLOCKS,
+             NoisePwrSpectrum::MIN_POLE_DENSITY, NoisePwrSpectrum::MAX_POLE_DENSITY,
+             RenderEngine::CHUNK_ALIGNMENT, MAX_PROCESSES );
+}
+
+
+//!************************************************************************
+//! Render a directory or a list of presets to WAV files
+//!
+//! @returns: 0 on success, 1 for an empty batch, 2 if any job failed
+//!************************************************************************
+int CommandLine::renderBatch
+    (
+    const std::string&  aSource,        //!< preset directory or list file
+    const std::string&  aOutDir,        //!< output directory
+    const uint64_t      aSeconds,       //!< length of every render [s]
+    const uint64_t      aSampleRate,    //!< sample rate [Hz]
+    const bool          aHasSeed,       //!< aSeed is used instead of the seeds derived from the presets
+    const uint64_t      aSeed,          //!< seed value
+    const uint64_t      aMaxJobs,       //!< maximum number of concurrent jobs
+    const uint64_t      aMemoryMb,      //!< memory budget [MB]
+    const uint64_t      aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+    const double        aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+    )
+{
+    std::vector<BatchRenderer::Job> jobVec;
+    int status = 0;
+
+    if( !BatchRenderer::collectJobs( aSource, aOutDir, jobVec ) )
+    {
+        fprintf( stderr, "Could not read \"%s\".\n", aSource.c_str() );
+        status = 2;
+    }
+    else if( jobVec.empty() )
+    {
+        fprintf( stderr, "\"%s\" does not contain any preset file.\n", aSource.c_str() );
+        status = 1;
+    }
+    else
+    {
+        BatchRenderer batchRenderer( static_cast<uint32_t>( aSampleRate ), aSeconds * aSampleRate );
+
+        if( aHasSeed )
+        {
+            batchRenderer.setSeed( static_cast<uint32_t>( aSeed ) );
+        }
+
+        batchRenderer.setMaxJobs( static_cast<unsigned>( aMaxJobs ) );
+        batchRenderer.setMemoryBudget( aMemoryMb << 20 );
+        batchRenderer.setNoiseDesign( static_cast<int>( aNrOfBlocks ), aPoleDensity );
+
+        if( batchRenderer.run( jobVec ) )
+        {
+            status = 2;
+        }
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Render a preset with several worker processes
+//!
+//! The sample range is split into one part per process, on multiples of
+//! RenderEngine::CHUNK_ALIGNMENT. Each worker is this program, rendering
+//! its part to a temporary WAV file with --start and --samples, using its
+//! share of the hardware threads for filtering noise; the parts
+//! are then concatenated into the output file and removed. The output is
+//! identical to the one of a single process render.
+//!
+//! @returns: 0 on success, 2 for I/O or worker errors
+//!************************************************************************
+int CommandLine::renderSplit
+    (
+    const std::string&  aProgram,       //!< path of this program
+    const std::string&  aPresetName,    //!< preset file name
+    const std::string&  aOutFileName,   //!< output file name
+    const uint64_t      aFirstSample,   //!< index of the first sample
+    const uint64_t      aNrOfSamples,   //!< number of samples
+    const uint64_t      aSampleRate,    //!< sample rate [Hz]
+    const uint64_t      aSeed,          //!< seed value
+    const uint64_t      aNrOfProcesses, //!< number of worker processes
+    const uint64_t      aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+    const double        aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+    )
+{
+    const uint64_t ALIGNMENT = RenderEngine::CHUNK_ALIGNMENT;
+    const uint64_t partSize = ( ( aNrOfSamples + aNrOfProcesses - 1 ) / aNrOfProcesses + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+    const uint64_t nrOfThreads = std::max<uint64_t>( 1, std::thread::hardware_concurrency() / aNrOfProcesses );
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::string> partNameVec;
+    std::vector<int> exitCodeVec;
+    std::vector<std::thread> workerVec;
+
+    for( uint64_t first = 0; first < aNrOfSamples; first += partSize )
+    {
+        partNameVec.push_back( aOutFileName + ".part" + std::to_string( partNameVec.size() ) );
+    }
+
+    exitCodeVec.resize( partNameVec.size(), -1 );
+
+    for( size_t k = 0; k < partNameVec.size(); k++ )
+    {
+        const uint64_t first = k * partSize;
+
+        std::vector<std::string> argVec =
+        {
+            aProgram,
+            "--render", aPresetName,
+            "--out", partNameVec[k],
+            "--rate", std::to_string( aSampleRate ),
+            "--seed", std::to_string( aSeed ),
+            "--start", std::to_string( aFirstSample + first ),
+            "--samples", std::to_string( std::min( partSize, aNrOfSamples - first ) ),
+            "--threads", std::to_string( nrOfThreads )
+        };
+
+        if( aNrOfBlocks )
+        {
+            argVec.insert( argVec.end(), { "--blocks", std::to_string( aNrOfBlocks ) } );
+        }
+
+        if( aPoleDensity )
+        {
+            char poleDensity[32];
+            snprintf( poleDensity, sizeof( poleDensity ), "%.17g", aPoleDensity );
+            argVec.insert( argVec.end(), { "--poles", poleDensity } );
+        }
+
+        workerVec.emplace_back( [argVec, k, &exitCodeVec]()
+                                {
+                                    exitCodeVec[k] = runProcess( argVec );
+                                } );
+    }
+
+    for( auto& crtWorker : workerVec )
+    {
+        crtWorker.join();
+    }
+
+    int status = 0;
+
+    for( size_t k = 0; k < exitCodeVec.size() && !status; k++ )
+    {
+        if( exitCodeVec[k] )
+        {
+            fprintf( stderr, "Worker %zu failed with code %d.\n", k, exitCodeVec[k] );
+            status = 2;
+        }
+    }
+
+    if( !status )
+    {
+        WavWriter wavWriter;
+        bool writeStatus = wavWriter.open( aOutFileName, static_cast<uint32_t>( aSampleRate ), 1 );
+
+        for( size_t k = 0; k < partNameVec.size() && writeStatus; k++ )
+        {
+            writeStatus = wavWriter.append( partNameVec[k] );
+        }
+
+        writeStatus = wavWriter.close() && writeStatus && wavWriter.getNrOfSamples() == aNrOfSamples;
+
+        if( writeStatus )
+        {
+            const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+            printf( "Stitched %zu parts, %llu samples at %llu Hz to \"%s\" in %.2f s\n",
+                    partNameVec.size(),
+                    static_cast<unsigned long long>( aNrOfSamples ),
+                    static_cast<unsigned long long>( aSampleRate ),
+                    aOutFileName.c_str(),
+                    elapsed );
+        }
+        else
+        {
+            fprintf( stderr, "Could not write file \"%s\".\n", aOutFileName.c_str() );
+            status = 2;
+        }
+    }
+
+    for( const auto& crtPartName : partNameVec )
+    {
+        std::remove( crtPartName.c_str() );
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Render a preset, or a batch of presets, to WAV files
+//!
+//! @returns: 0 on success, 1 for invalid arguments, 2 for I/O errors
+//!************************************************************************
+int CommandLine::run
+    (
+    int     argc,           //!< number of arguments
+    char*   argv[]          //!< arguments
+    )
+{
+#if defined( _WIN32 )
+    // a GUI subsystem executable has no console of its own
+    if( AttachConsole( ATTACH_PARENT_PROCESS ) )
+    {
+        freopen( "CONOUT$", "w", stdout );
+        freopen( "CONOUT$", "w", stderr );
+    }
+#endif
+
+    const uint64_t MAX_SAMPLES = static_cast<uint64_t>( MAX_SECONDS ) * MAX_SAMPLE_RATE;
+
+    std::string presetFileName;
+    std::string outFileName;
+    std::string batchSource;
+    std::string outDir;
+    uint64_t seconds = DEFAULT_SECONDS;
+    uint64_t sampleRate = DEFAULT_SAMPLE_RATE;
+    uint64_t seed = 0;
+    bool hasSeed = false;
+    uint64_t maxJobs = 0;
+    uint64_t memoryMb = 0;
+    uint64_t firstSample = 0;
+    uint64_t nrOfSamples = 0;
+    uint64_t nrOfProcesses = 1;
+    uint64_t nrOfThreads = 0;
+    uint64_t nrOfBlocks = 0;
+    double poleDensity = 0;
+    bool argsOk = true;
+    bool helpRequested = false;
+
+    for( int i = 1; i < argc && argsOk && !helpRequested; i++ )
+    {
+        const std::string option = argv[i];
+        const bool hasValue = ( i + 1 < argc );
+
+        if( "--help" == option )
+        {
+            helpRequested = true;
+        }
+        else if( "--render" == option && hasValue )
+        {
+            presetFileName = argv[++i];
+        }
+        else if( "--out" == option && hasValue )
+        {
+            outFileName = argv[++i];
+        }
+        else if( "--batch" == option && hasValue )
+        {
+            batchSource = argv[++i];
+        }
+        else if( "--outdir" == option && hasValue )
+        {
+            outDir = argv[++i];
+        }
+        else if( "--jobs" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], maxJobs ) && maxJobs > 0 && maxJobs <= UINT16_MAX;
+        }
+        else if( "--memory" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], memoryMb ) && memoryMb > 0 && memoryMb <= UINT32_MAX;
+        }
+        else if( "--start" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], firstSample ) && 0 == firstSample % RenderEngine::CHUNK_ALIGNMENT && firstSample <= MAX_SAMPLES;
+        }
+        else if( "--samples" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], nrOfSamples ) && nrOfSamples > 0 && nrOfSamples <= MAX_SAMPLES;
+        }
+        else if( "--processes" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], nrOfProcesses ) && nrOfProcesses > 0 && nrOfProcesses <= MAX_PROCESSES;
+        }
+        else if( "--threads" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], nrOfThreads ) && nrOfThreads > 0 && nrOfThreads <= UINT16_MAX;
+        }
+        else if( "--seconds" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], seconds ) && seconds > 0 && seconds <= MAX_SECONDS;
+        }
+        else if( "--rate" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], sampleRate ) && sampleRate >= MIN_SAMPLE_RATE && sampleRate <= MAX_SAMPLE_RATE;
+        }
+        else if( "--seed" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], seed ) && seed <= UINT32_MAX;
+            hasSeed = true;
+        }
+        else if( "--blocks" == option && hasValue )
+        {
+            argsOk = parseUnsigned( argv[++i], nrOfBlocks )
+                  && nrOfBlocks >= NoisePwrSpectrum::MIN_NR_OF_FILTER_BLOCKS
+                  && nrOfBlocks <= NoisePwrSpectrum::MAX_NR_OF_FILTER_BLOCKS;
+        }
+        else if( "--poles" == option && hasValue )
+        {
+            argsOk = parseDouble( argv[++i], poleDensity )
+                  && poleDensity >= NoisePwrSpectrum::MIN_POLE_DENSITY
+                  && poleDensity <= NoisePwrSpectrum::MAX_POLE_DENSITY;
+        }
+        else
+        {
+            argsOk = false;
+        }
+
+        if( !argsOk )
+        {
+            fprintf( stderr, "Invalid argument: %s\n", option.c_str() );
+        }
+    }
+
+    int status = 0;
+
+    NoisePwrSpectrum::setMaxThreads( static_cast<unsigned>( nrOfThreads ) );
+
+    if( 0 == nrOfSamples )
+    {
+        nrOfSamples = seconds * sampleRate;
+    }
+
+    if( helpRequested )
+    {
+        printUsage( stdout );
+    }
+    else if( argsOk && !batchSource.empty() && presetFileName.empty() && outFileName.empty() )
+    {
+        status = renderBatch( batchSource, outDir, seconds, sampleRate, hasSeed, seed, maxJobs, memoryMb, nrOfBlocks, poleDensity );
+    }
+    else if( !argsOk || presetFileName.empty() || outFileName.empty() || !batchSource.empty() )
+    {
+        printUsage( stderr );
+        status = 1;
+    }
+    else
+    {
+        std::vector<SignalItem*> signalsVector;
+
+        if( !PresetFile::read( presetFileName, signalsVector ) )
+        {
+            fprintf( stderr, "Could not open file \"%s\".\n", presetFileName.c_str() );
+            status = 2;
+        }
+        else if( signalsVector.empty() )
+        {
+            fprintf( stderr, "The file \"%s\" does not contain any valid signal.\n", presetFileName.c_str() );
+            status = 1;
+        }
+        else
+        {
+            BatchRenderer::applyNoiseDesign( signalsVector, static_cast<int>( nrOfBlocks ), poleDensity );
+
+            // the same seed as the GUI, so the preset renders the noise it plays
+            if( !hasSeed )
+            {
+                seed = RenderCache::getSeed( RenderCache::hashItems( signalsVector ) );
+            }
+
+            if( nrOfProcesses > 1 )
+            {
+                status = renderSplit( argv[0], presetFileName, outFileName, firstSample, nrOfSamples, sampleRate, seed, nrOfProcesses, nrOfBlocks, poleDensity );
+            }
+            else
+            {
+                const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+                RenderEngine renderEngine( static_cast<uint32_t>( sampleRate ), static_cast<uint32_t>( seed ) );
+                renderEngine.setData( signalsVector );
+
+                if( renderEngine.renderToWav( outFileName, nrOfSamples, firstSample ) )
+                {
+                    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+                    printf( "Rendered %zu signal items, %llu samples at %llu Hz to \"%s\" in %.2f s\n",
+                            signalsVector.size(),
+                            static_cast<unsigned long long>( nrOfSamples ),
+                            static_cast<unsigned long long>( sampleRate ),
+                            outFileName.c_str(),
+                            elapsed );
+                }
+                else
+                {
+                    fprintf( stderr, "Could not write file \"%s\".\n", outFileName.c_str() );
+                    status = 2;
+                }
+            }
+        }
+
+        for( auto& crtSignal : signalsVector )
+        {
+            delete crtSignal;
+        }
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Run a program and wait for it to exit
+//!
+//! The arguments are passed to the program as they are, without a shell,
+//! so file names may contain any character. On Windows they are quoted
+//! for the command line parser of the C runtime.
+//!
+//! @returns: exit code of the program, -1 if it could not be run
+//!************************************************************************
+int CommandLine::runProcess
+    (
+    const std::vector<std::string>& aArgVec     //!< program followed by its arguments
+    )
+{
+    int exitCode = -1;
+
+#if defined( _WIN32 )
+    std::string commandLine;
+
+    for( const auto& crtArg : aArgVec )
+    {
+        size_t nrOfBackslashes = 0;
+
+        commandLine += commandLine.empty() ? "\"" : " \"";
+
+        for( const char crtChar : crtArg )
+        {
+            if( '\\' == crtChar )
+            {
+                nrOfBackslashes++;
+            }
+            else
+            {
+                // backslashes are literal unless they precede a quote
+                const size_t nrOfCopies = ( '"' == crtChar ) ? 2 * nrOfBackslashes + 1 : nrOfBackslashes;
+                commandLine.append( nrOfCopies, '\\' );
+                commandLine += crtChar;
+                nrOfBackslashes = 0;
+            }
+        }
+
+        commandLine.append( 2 * nrOfBackslashes, '\\' );
+        commandLine += "\"";
+    }
+
+    STARTUPINFOA startupInfo = {};
+    PROCESS_INFORMATION processInfo = {};
+    startupInfo.cb = sizeof( startupInfo );
+
+    if( CreateProcessA( nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo ) )
+    {
+        DWORD processExitCode = 0;
+
+        WaitForSingleObject( processInfo.hProcess, INFINITE );
+
+        if( GetExitCodeProcess( processInfo.hProcess, &processExitCode ) )
+        {
+            exitCode = static_cast<int>( processExitCode );
+        }
+
+        CloseHandle( processInfo.hThread );
+        CloseHandle( processInfo.hProcess );
+    }
+#else
+    std::vector<char*> argVec;
+
+    for( const auto& crtArg : aArgVec )
+    {
+        argVec.push_back( const_cast<char*>( crtArg.c_str() ) );
+    }
+
+    argVec.push_back( nullptr );
+
+    pid_t pid = 0;
+
+    if( 0 == posix_spawnp( &pid, argVec[0], nullptr, nullptr, argVec.data(), environ ) )
+    {
+        int waitStatus = 0;
+        pid_t waitResult = 0;
+
+        do
+        {
+            waitResult = waitpid( pid, &waitStatus, 0 );
+        }
+        while( waitResult < 0 && EINTR == errno );
+
+        if( waitResult == pid && WIFEXITED( waitStatus ) )
+        {
+            exitCode = WEXITSTATUS( waitStatus );
+        }
+    }
+#endif
+
+    return exitCode;
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+CommandLine.h
+This file contains the definitions for the command line (headless) mode.
+*/
+
+#ifndef CommandLine_h
+#define CommandLine_h
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+//************************************************************************
+// Class for running the generator from the command line
+//
+//   Sippora --render preset.txt --out file.wav [--seconds 10] [--rate 44100] [--seed 1] [--blocks 7] [--poles 1.1]
+//   Sippora --batch <dir|list.txt> [--outdir dir] [--jobs n] [--memory MB] [...]
+//
+// The preset is rendered to a WAV file and the process exits, without
+// creating any widget or audio device. In batch mode, many presets are
+// rendered concurrently (see BatchRenderer). A single long render can be
+// split between worker processes with --processes. --blocks and --poles
+// replace the noise filter design of every noise item of the presets.
+// Without --seed, the seed of each preset is derived from its items as
+// in the GUI (see RenderCache::getSeed()), so a preset renders the same
+// noise as it plays.
+//
+// The same options are accepted by SipporaCli, a console executable
+// without Qt. On Windows, Sippora is a GUI subsystem program which the
+// console does not wait for, so scripts should use SipporaCli.
+//************************************************************************
+class CommandLine
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        static const uint32_t DEFAULT_SECONDS = 10;         //!< default length of the render [s]
+        static const uint32_t DEFAULT_SAMPLE_RATE = 44100;  //!< default sample rate [Hz]
+        static const uint32_t MIN_SAMPLE_RATE = 8000;       //!< minimum sample rate [Hz]
+        static const uint32_t MAX_SAMPLE_RATE = 768000;     //!< maximum sample rate [Hz]
+        static const uint32_t MAX_PROCESSES = 256;          //!< maximum number of worker processes
+        static const uint32_t MAX_SECONDS = 7 * 24 * 3600;  //!< maximum length of the render [s]
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static bool isRequested
+            (
+            int     argc,           //!< number of arguments
+            char*   argv[]          //!< arguments
+            );
+
+        static int run
+            (
+            int     argc,           //!< number of arguments
+            char*   argv[]          //!< arguments
+            );
+
+    private:
+        static int renderBatch
+            (
+            const std::string&  aSource,        //!< preset directory or list file
+            const std::string&  aOutDir,        //!< output directory
+            const uint64_t      aSeconds,       //!< length of every render [s]
+            const uint64_t      aSampleRate,    //!< sample rate [Hz]
+            const bool          aHasSeed,       //!< aSeed is used instead of the seeds derived from the presets
+            const uint64_t      aSeed,          //!< seed value
+            const uint64_t      aMaxJobs,       //!< maximum number of concurrent jobs
+            const uint64_t      aMemoryMb,      //!< memory budget [MB]
+            const uint64_t      aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+            const double        aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+            );
+
+        static int renderSplit
+            (
+            const std::string&  aProgram,       //!< path of this program
+            const std::string&  aPresetName,    //!< preset file name
+            const std::string&  aOutFileName,   //!< output file name
+            const uint64_t      aFirstSample,   //!< index of the first sample
+            const uint64_t      aNrOfSamples,   //!< number of samples
+            const uint64_t      aSampleRate,    //!< sample rate [Hz]
+            const uint64_t      aSeed,          //!< seed value
+            const uint64_t      aNrOfProcesses, //!< number of worker processes
+            const uint64_t      aNrOfBlocks,    //!< number of noise filter blocks, 0 to keep
+            const double        aPoleDensity    //!< poles / decade of the noise filters, 0 to keep
+            );
+
+        static bool parseDouble
+            (
+            const std::string&  aString,    //!< string
+            double&             aValue      //!< value
+            );
+
+        static bool parseUnsigned
+            (
+            const std::string&  aString,    //!< string
+            uint64_t&           aValue      //!< value
+            );
+
+        static void printUsage
+            (
+            FILE*   aStream         //!< output stream
+            );
+
+        static int runProcess
+            (
+            const std::vector<std::string>& aArgVec     //!< program followed by its arguments
+            );
+};
+
+#endif // CommandLine_h
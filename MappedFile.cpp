@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+MappedFile.cpp
+This file contains the sources for read-only memory mapped files.
+*/
+
+#include "MappedFile.h"
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+MappedFile::MappedFile
+    (
+    const std::string&  aFileName       //!< file name
+    )
+    : mData( nullptr )
+    , mSize( 0 )
+{
+#if defined( _WIN32 )
+    HANDLE file = CreateFileA( aFileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    if( INVALID_HANDLE_VALUE != file )
+    {
+        LARGE_INTEGER fileSize;
+
+        if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 )
+        {
+            HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+            if( mapping )
+            {
+                mData = static_cast<const char*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+                mSize = mData ? static_cast<size_t>( fileSize.QuadPart ) : 0;
+                CloseHandle( mapping );
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int file = open( aFileName.c_str(), O_RDONLY );
+
+    if( file >= 0 )
+    {
+        struct stat fileStat;
+
+        if( 0 == fstat( file, &fileStat ) && fileStat.st_size > 0 )
+        {
+            void* mapped = mmap( nullptr, static_cast<size_t>( fileStat.st_size ), PROT_READ, MAP_PRIVATE, file, 0 );
+
+            if( MAP_FAILED != mapped )
+            {
+                mData = static_cast<const char*>( mapped );
+                mSize = static_cast<size_t>( fileStat.st_size );
+            }
+        }
+
+        close( file );
+    }
+#endif
+}
+
+
+//!************************************************************************
+//! Destructor
+//!************************************************************************
+MappedFile::~MappedFile()
+{
+    if( mData )
+    {
+#if defined( _WIN32 )
+        UnmapViewOfFile( mData );
+#else
+        munmap( const_cast<char*>( mData ), mSize );
+#endif
+    }
+}
+
+
+//!************************************************************************
+//! Get the start of the mapped file
+//!
+//! @returns: start of the file, nullptr if not mapped
+//!************************************************************************
+const char* MappedFile::getData() const
+{
+    return mData;
+}
+
+
+//!************************************************************************
+//! Get the size of the mapped file
+//!
+//! @returns: size [bytes], 0 if not mapped
+//!************************************************************************
+size_t MappedFile::getSize() const
+{
+    return mSize;
+}
+
+
+//!************************************************************************
+//! Check if the file is mapped
+//!
+//! @returns: true if the file is mapped
+//!************************************************************************
+bool MappedFile::isOpen() const
+{
+    return nullptr != mData;
+}
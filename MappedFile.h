@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+MappedFile.h
+This file contains the definitions for read-only memory mapped files.
+*/
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <cstddef>
+#include <string>
+
+
+//************************************************************************
+// Class for mapping a whole file in memory, read-only
+//
+// The file is unmapped when the object is destroyed. Empty files and
+// files which cannot be opened are not mapped, see isOpen().
+//************************************************************************
+class MappedFile
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        MappedFile
+            (
+            const std::string&  aFileName       //!< file name
+            );
+
+        ~MappedFile();
+
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        const char* getData() const;
+
+        size_t getSize() const;
+
+        bool isOpen() const;
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        const char*     mData;          //!< start of the mapped file
+        size_t          mSize;          //!< size of the file [bytes]
+};
+
+#endif // MappedFile_h
@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+NoiseGenerator.cpp
+This file contains the sources for the block noise generator.
+*/
+
+#include "NoiseGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+const size_t NoiseGenerator::BLOCK_SIZE;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+NoiseGenerator::NoiseGenerator
+    (
+    const uint32_t  aSeed       //!< seed value
+    )
+    : mKey( 0 )
+    , mPosition( 0 )
+{
+    mKey = hashCounter( aSeed );
+}
+
+
+//!************************************************************************
+//! Fill a block with Gaussian white noise of zero mean and unit RMS
+//! using the Box-Muller transform
+//!
+//! Each counter value provides two uniform numbers, which are transformed
+//! into two normal deviates. Counters are hashed for a whole block first,
+//! then transformed in a second pass. Neither pass carries state between
+//! iterations, so any position can be generated without the previous ones,
+//! and neither calls the math library, so both are vectorised.
+//!
+//! Reference:
+//! [1] Box, G.E.P., Muller, M.E. - A Note on the Generation of Random Normal Deviates,
+//!                                 Ann. Math. Statist. 29 (2), 1958, pp. 610-611
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoiseGenerator::fillGauss
+    (
+    double*         aData,      //!< output samples
+    const size_t    aCount      //!< number of samples
+    )
+{
+    const double INV_2_POW_32 = 1.0 / 4294967296.0;
+    const double TWO_POW_52 = 4503599627370496.0;
+    const uint64_t TWO_POW_52_BITS = 0x4330000000000000ULL;
+
+    uint64_t hashVec[BLOCK_SIZE];
+    double u1Vec[BLOCK_SIZE];
+    double u2Vec[BLOCK_SIZE];
+    double logVec[BLOCK_SIZE];
+    double sinVec[BLOCK_SIZE];
+    double cosVec[BLOCK_SIZE];
+    double pairVec[2 * BLOCK_SIZE];
+
+    size_t written = 0;
+
+    while( written < aCount )
+    {
+        const uint64_t firstPair = mPosition / 2;
+        const size_t skip = mPosition % 2;
+        const size_t nrPairs = std::min<size_t>( BLOCK_SIZE, ( skip + aCount - written + 1 ) / 2 );
+
+        for( size_t i = 0; i < nrPairs; i++ )
+        {
+            hashVec[i] = hashCounter( firstPair + i );
+        }
+
+        for( size_t i = 0; i < nrPairs; i++ )
+        {
+            // 2^52 + k is built from the bits of k, since SSE2 has no
+            // vector conversion of 64 bit or unsigned integers
+            const uint64_t hiBits = TWO_POW_52_BITS | ( hashVec[i] >> 32 );
+            const uint64_t loBits = TWO_POW_52_BITS | ( hashVec[i] & 0xffffffff );
+            double hi;
+            double lo;
+            std::memcpy( &hi, &hiBits, sizeof( hi ) );
+            std::memcpy( &lo, &loBits, sizeof( lo ) );
+
+            u1Vec[i] = ( hi - TWO_POW_52 + 1.0 ) * INV_2_POW_32;     // (0..1]
+            u2Vec[i] = ( lo - TWO_POW_52 ) * INV_2_POW_32;           // [0..1)
+        }
+
+        getLog( u1Vec, logVec, nrPairs );
+        getSinCos( u2Vec, sinVec, cosVec, nrPairs );
+
+        for( size_t i = 0; i < nrPairs; i++ )
+        {
+            const double r = std::sqrt( -2.0 * logVec[i] );
+
+            pairVec[2 * i] = r * cosVec[i];
+            pairVec[2 * i + 1] = r * sinVec[i];
+        }
+
+        const size_t n = std::min( 2 * nrPairs - skip, aCount - written );
+        std::copy( pairVec + skip, pairVec + skip + n, aData + written );
+
+        written += n;
+        mPosition += n;
+    }
+}
+
+
+//!************************************************************************
+//! Get the natural logarithms of normal numbers in (0..1]
+//!
+//! Each value is split into 2^e * m with m in [sqrt(2)/2..sqrt(2)), and
+//! log(m) is evaluated with the polynomial of the fdlibm __ieee754_log,
+//! whose error is below 1 ulp. The loop has no branches and no library
+//! calls, so it is vectorised.
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoiseGenerator::getLog
+    (
+    const double*   aValue,     //!< values in (0..1]
+    double*         aLog,       //!< natural logarithms
+    const size_t    aCount      //!< number of values
+    )
+{
+    const double TWO_POW_52 = 4503599627370496.0;
+    const uint64_t TWO_POW_52_BITS = 0x4330000000000000ULL;
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double LG1 = 6.666666666666735130e-01;
+    const double LG2 = 3.999999999940941908e-01;
+    const double LG3 = 2.857142874366239149e-01;
+    const double LG4 = 2.222219843214978396e-01;
+    const double LG5 = 1.818357216161805012e-01;
+    const double LG6 = 1.531383769920937332e-01;
+    const double LG7 = 1.479819860511658591e-01;
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &aValue[i], sizeof( bits ) );
+
+        // shift the mantissa by half an octave, so m lands in [sqrt(2)/2..sqrt(2))
+        bits += 0x3ff0000000000000ULL - 0x3fe6a09e00000000ULL;
+
+        // the biased exponent k as 2^52 + k, without an integer conversion
+        const uint64_t expBits = TWO_POW_52_BITS | ( bits >> 52 );
+        double biasedExp;
+        std::memcpy( &biasedExp, &expBits, sizeof( biasedExp ) );
+
+        const double e = biasedExp - ( TWO_POW_52 + 1023 );
+        bits = ( bits & 0x000fffffffffffffULL ) + 0x3fe6a09e00000000ULL;
+
+        double m;
+        std::memcpy( &m, &bits, sizeof( m ) );
+
+        const double f = m - 1.0;
+        const double s = f / ( 2.0 + f );
+        const double z = s * s;
+        const double w = z * z;
+        const double r = z * ( LG1 + w * ( LG3 + w * ( LG5 + w * LG7 ) ) ) + w * ( LG2 + w * ( LG4 + w * LG6 ) );
+        const double hfsq = 0.5 * f * f;
+
+        aLog[i] = e * LN2_HI - ( ( hfsq - ( s * ( hfsq + r ) + e * LN2_LO ) ) - f );
+    }
+}
+
+
+//!************************************************************************
+//! Get the index of the next generated sample
+//!
+//! @returns: sample index
+//!************************************************************************
+uint64_t NoiseGenerator::getPosition() const
+{
+    return mPosition;
+}
+
+
+//!************************************************************************
+//! Get the sines and the cosines of angles in turns
+//!
+//! Each angle is reduced exactly to the nearest quarter turn, and the
+//! remainder in [-pi/4..pi/4] is evaluated with the polynomials of the
+//! fdlibm __kernel_sin and __kernel_cos. The quadrant is applied by
+//! selects, so the loop has no branches and no library calls and it is
+//! vectorised.
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoiseGenerator::getSinCos
+    (
+    const double*   aTurns,     //!< angles [turns], in [0..1)
+    double*         aSin,       //!< sines
+    double*         aCos,       //!< cosines
+    const size_t    aCount      //!< number of angles
+    )
+{
+    const double TWO_PI = 2.0 * M_PI;
+    const double ROUND = 6755399441055744.0;    // 1.5 * 2^52, adding it rounds to an integer
+    const uint64_t SIGN_BIT = 0x8000000000000000ULL;
+    const double S1 = -1.66666666666666324348e-01;
+    const double S2 = 8.33333333332248946124e-03;
+    const double S3 = -1.98412698298579493134e-04;
+    const double S4 = 2.75573137070700676789e-06;
+    const double S5 = -2.50507602534068634195e-08;
+    const double S6 = 1.58969099521155010221e-10;
+    const double C1 = 4.16666666666666019037e-02;
+    const double C2 = -1.38888888888741095749e-03;
+    const double C3 = 2.48015872894767294178e-05;
+    const double C4 = -2.75573143513906633035e-07;
+    const double C5 = 2.08757232129817482790e-09;
+    const double C6 = -1.13596475577881948265e-11;
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        // nearest quarter turn q, in the low bits of the mantissa of rounded
+        const double rounded = 4.0 * aTurns[i] + ROUND;
+        const double quarter = rounded - ROUND;
+
+        // the angles have at most 32 significant bits, so the remainder is exact
+        const double x = TWO_PI * ( aTurns[i] - 0.25 * quarter );
+        const double z = x * x;
+
+        const double sinX = x + x * z * ( S1 + z * ( S2 + z * ( S3 + z * ( S4 + z * ( S5 + z * S6 ) ) ) ) );
+        const double cosX = 1.0 - 0.5 * z + z * z * ( C1 + z * ( C2 + z * ( C3 + z * ( C4 + z * ( C5 + z * C6 ) ) ) ) );
+
+        // rotate by q: sin( x + q * pi/2 ), cos( x + q * pi/2 ), with bit masks
+        uint64_t q;
+        uint64_t sinBits;
+        uint64_t cosBits;
+        std::memcpy( &q, &rounded, sizeof( q ) );
+        std::memcpy( &sinBits, &sinX, sizeof( sinBits ) );
+        std::memcpy( &cosBits, &cosX, sizeof( cosBits ) );
+
+        const uint64_t swapMask = 0 - ( q & 1 );
+        uint64_t sinAbsBits = ( sinBits & ~swapMask ) | ( cosBits & swapMask );
+        uint64_t cosAbsBits = ( cosBits & ~swapMask ) | ( sinBits & swapMask );
+
+        sinAbsBits ^= ( q << 62 ) & SIGN_BIT;
+        cosAbsBits ^= ( ( q + 1 ) << 62 ) & SIGN_BIT;
+
+        std::memcpy( &aSin[i], &sinAbsBits, sizeof( double ) );
+        std::memcpy( &aCos[i], &cosAbsBits, sizeof( double ) );
+    }
+}
+
+
+//!************************************************************************
+//! Hash a counter value (SplitMix64 finalizer)
+//! adapted from Steele, G.L. et al - Fast Splittable Pseudorandom Number Generators,
+//!                                   OOPSLA 2014, pp. 453-472
+//!
+//! @returns: 64 random bits
+//!************************************************************************
+uint64_t NoiseGenerator::hashCounter
+    (
+    const uint64_t  aCounter    //!< counter value
+    ) const
+{
+    uint64_t z = mKey + aCounter * 0x9e3779b97f4a7c15ULL;
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+
+    return z ^ ( z >> 31 );
+}
+
+
+//!************************************************************************
+//! Set the index of the next generated sample
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoiseGenerator::setPosition
+    (
+    const uint64_t  aPosition   //!< sample index
+    )
+{
+    mPosition = aPosition;
+}
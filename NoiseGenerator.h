@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+NoiseGenerator.h
+This file contains the definitions for the block noise generator.
+*/
+
+#ifndef NoiseGenerator_h
+#define NoiseGenerator_h
+
+#include <cstddef>
+#include <cstdint>
+
+
+//************************************************************************
+// Class for generating blocks of white noise samples
+//
+// The generator is counter-based: the value at a given sample index
+// depends only on the seed and on that index, so blocks can be filled
+// without any loop-carried state and any position can be reached in O(1).
+// The logarithm, sine and cosine of the transform are branch-free
+// polynomials instead of library calls, so the compiler can vectorise
+// the block loops.
+//************************************************************************
+class NoiseGenerator
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        static const size_t BLOCK_SIZE = 256;       //!< number of samples transformed in one pass
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        NoiseGenerator
+            (
+            const uint32_t  aSeed       //!< seed value
+            );
+
+        void fillGauss
+            (
+            double*         aData,      //!< output samples
+            const size_t    aCount      //!< number of samples
+            );
+
+        uint64_t getPosition() const;
+
+        void setPosition
+            (
+            const uint64_t  aPosition   //!< sample index
+            );
+
+    private:
+        static void getLog
+            (
+            const double*   aValue,     //!< values in (0..1]
+            double*         aLog,       //!< natural logarithms
+            const size_t    aCount      //!< number of values
+            );
+
+        static void getSinCos
+            (
+            const double*   aTurns,     //!< angles [turns], in [0..1)
+            double*         aSin,       //!< sines
+            double*         aCos,       //!< cosines
+            const size_t    aCount      //!< number of angles
+            );
+
+        uint64_t hashCounter
+            (
+            const uint64_t  aCounter    //!< counter value
+            ) const;
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        uint64_t        mKey;           //!< key derived from the seed
+        uint64_t        mPosition;      //!< index of the next generated sample
+};
+
+#endif // NoiseGenerator_h
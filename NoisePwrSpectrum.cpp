@@ -24,6 +24,16 @@ This file contains the sources for the noise power spectral density.
 
 #include <algorithm>
 #include <cmath>
+#include <complex>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+const size_t NoisePwrSpectrum::MAX_LANES;
+const size_t NoisePwrSpectrum::MAX_GRID_DESIGNS;
+const size_t NoisePwrSpectrum::MAX_OFF_GRID_FILTERS;
 
 
 //!************************************************************************
@@ -31,10 +41,16 @@ This file contains the sources for the noise power spectral density.
 //!************************************************************************
 NoisePwrSpectrum::NoisePwrSpectrum
     (
-    double aGamma   //!< frequency exponent
+    double      aGamma,         //!< frequency exponent
+    uint32_t    aSampleRate,    //!< sample rate [Hz]
+    int         aNrOfBlocks,    //!< number of filter blocks
+    double      aPoleDensity    //!< number of poles / decade
     )
 {
     mGamma = 0;
+    mSampleRate = aSampleRate;
+    mNrOfBlocks = DEFAULT_NR_OF_FILTER_BLOCKS;
+    mPoleDensity = DEFAULT_POLE_DENSITY;
 
     if( GAMMA_MIN <= aGamma
      && aGamma <= GAMMA_MAX
@@ -43,9 +59,22 @@ NoisePwrSpectrum::NoisePwrSpectrum
         mGamma = aGamma;
     }
 
-    calculateFilterBlockCoeffs();
+    if( MIN_NR_OF_FILTER_BLOCKS <= aNrOfBlocks
+     && aNrOfBlocks <= MAX_NR_OF_FILTER_BLOCKS
+      )
+    {
+        mNrOfBlocks = aNrOfBlocks;
+    }
+
+    if( MIN_POLE_DENSITY <= aPoleDensity
+     && aPoleDensity <= MAX_POLE_DENSITY
+      )
+    {
+        mPoleDensity = aPoleDensity;
+    }
+
     updateFilter();
-} 
+}
 
 
 //!************************************************************************
@@ -63,7 +92,11 @@ NoisePwrSpectrum::~NoisePwrSpectrum()
 //! H(z) = ------------- * ------------- *...* -------------
 //!        1 - a1*z^(-1)   1 - a2*z^(-1)       1 - aN*z^(-1)
 //!
-//! N = NR_OF_FILTER_BLOCKS
+//! N = number of filter blocks
+//!
+//! The last pole is placed just below the Nyquist frequency, and the
+//! others follow downwards with the given pole density, so fewer blocks
+//! raise the lower edge of the band where the slope is respected.
 //!
 //! References:
 //! [1] Corsini, G., Saletti, R. - A 1/f^gamma Power Spectrum Noise Sequence Generator,
@@ -73,180 +106,167 @@ NoisePwrSpectrum::~NoisePwrSpectrum()
 //!
 //! @returns: nothing
 //!************************************************************************
-void NoisePwrSpectrum::calculateFilterBlockCoeffs()
+void NoisePwrSpectrum::calculateFilterBlockCoeffs
+    (
+    const FilterKey&        aKey,               //!< filter design parameters
+    std::vector<double>&    aBBlockCoeffVec,    //!< block filter coefficients (numerator)
+    std::vector<double>&    aABlockCoeffVec     //!< block filter coefficients (denominator)
+    )
 {
-    mABlockCoeffVec.clear();
-    mBBlockCoeffVec.clear();
+    const int N = aKey.nrOfBlocks;
+
+    aABlockCoeffVec.clear();
+    aBBlockCoeffVec.clear();
 
-    mABlockCoeffVec.resize( NR_OF_FILTER_BLOCKS );
-    mBBlockCoeffVec.resize( NR_OF_FILTER_BLOCKS );
+    aABlockCoeffVec.resize( N );
+    aBBlockCoeffVec.resize( N );
 
     // pole density == number of poles / decade, see Fig. 2 in [2]
-    const double POLE_DENSITY = 1.1;
+    const double POLE_DENSITY = aKey.poleDensity;
 
     // last zero constant = 0.30103
     const double C = -log10( 0.5 );
 
-    for( int i = 1; i <= NR_OF_FILTER_BLOCKS; i++ )
+    for( int i = 1; i <= N; i++ )
     {
-        double e = ( i - NR_OF_FILTER_BLOCKS ) / POLE_DENSITY - 0.5 * mGamma / POLE_DENSITY - C;
+        double e = ( i - N ) / POLE_DENSITY - 0.5 * aKey.gamma / POLE_DENSITY - C;
         double a = exp( -2.0 * M_PI * pow( 10.0, e ) );
-        e +=  0.5 * mGamma / POLE_DENSITY;
+        e +=  0.5 * aKey.gamma / POLE_DENSITY;
         double b = exp( -2.0 * M_PI * pow( 10.0, e ) );
 
-        mABlockCoeffVec[i - 1] = a;
-        mBBlockCoeffVec[i - 1] = b;
+        aABlockCoeffVec[i - 1] = a;
+        aBBlockCoeffVec[i - 1] = b;
     }
 }
 
 
 //!************************************************************************
-//! Calculate the filter coefficients in polynomial form for N=7
+//! Calculate the filter coefficients in polynomial form
 //!
-//!        B0 + B1*z^(-1) + ... + B7*z^(-1)
+//!        B0 + B1*z^(-1) + ... + BN*z^(-N)
 //! H(z) = --------------------------------
-//!        A0 + A1*z^(-1) + ... + A7*z^(-1)
+//!        A0 + A1*z^(-1) + ... + AN*z^(-N)
+//!
+//! The product of the N first order blocks is expanded one block at a
+//! time, i.e. P_k(z) = P_(k-1)(z) * ( 1 - c_k*z^(-1) ), with P_0(z) = 1.
 //!
 //! @returns: nothing
 //!************************************************************************
 void NoisePwrSpectrum::calculateFilterPolyCoeffs
     (
-    const std::vector<double>   aBlockCoeffVec,     //!< filter coefficients / block
+    const std::vector<double>&  aBlockCoeffVec,     //!< filter coefficients / block
     std::vector<double>&        aPolyCoeffVec       //!< filter coefficients / poly
     )
 {
-    std::vector<double> b( aBlockCoeffVec.size() + 1 );
+    const size_t N = aBlockCoeffVec.size();
 
-    for( size_t i = 0; i < aBlockCoeffVec.size(); i++ )
+    aPolyCoeffVec.assign( N + 1, 0 );
+    aPolyCoeffVec[0] = 1;
+
+    for( size_t k = 1; k <= N; k++ )
     {
-        b[i + 1] = aBlockCoeffVec[i];
+        for( size_t j = k; j >= 1; j-- )
+        {
+            aPolyCoeffVec[j] -= aBlockCoeffVec[k - 1] * aPolyCoeffVec[j - 1];
+        }
     }
+}
 
-    //********
-    // 0
-    //********
-    aPolyCoeffVec[0] = 1;
 
-    //********
-    // 1
-    //********
-    double s12 = b[1] + b[2];
-    double s13 = s12 + b[3];
-    double s14 = s13 + b[4];
-    double s15 = s14 + b[5];
-    double s16 = s15 + b[6];
-    double s17 = s16 + b[7];
-
-    aPolyCoeffVec[1] = -s17;
-
-    //********
-    // 2
-    //********
-    double b1b2 = b[1] * b[2];
-    double b1b3 = b[1] * b[3];
-    double b1b4 = b[1] * b[4];
-    double b1b5 = b[1] * b[5];
-    double b1b6 = b[1] * b[6];
-    double b1b7 = b[1] * b[7];
-
-    double b2b3 = b[2] * b[3];
-    double b2b4 = b[2] * b[4];
-    double b2b5 = b[2] * b[5];
-    double b2b6 = b[2] * b[6];
-    double b2b7 = b[2] * b[7];
-
-    double b3b4 = b[3] * b[4];
-    double b3b5 = b[3] * b[5];
-    double b3b6 = b[3] * b[6];
-    double b3b7 = b[3] * b[7];
-
-    double b4b5 = b[4] * b[5];
-    double b4b6 = b[4] * b[6];
-    double b4b7 = b[4] * b[7];
-
-    double b5b6 = b[5] * b[6];
-    double b5b7 = b[5] * b[7];
-
-    double b6b7 = b[6] * b[7];
-
-    aPolyCoeffVec[2] = b1b2 + b1b3 + b1b4 + b1b5 + b1b6 + b1b7
-                            + b2b3 + b2b4 + b2b5 + b2b6 + b2b7
-                                   + b3b4 + b3b5 + b3b6 + b3b7
-                                          + b4b5 + b4b6 + b4b7
-                                                 + b5b6 + b5b7
-                                                        + b6b7;
-    //********
-    // 3
-    //********
-    double s67 = b[6] + b[7];
-    double s57 = b[5] + s67;
-    double s47 = b[4] + s57;
-    double s37 = b[3] + s47;
-
-    double tmp = s37 * b1b2
-               + s47 * b[3] * s12
-               + s57 * b[4] * s13
-               + s67 * b[5] * s14
-               + b6b7 * s15;
-
-    aPolyCoeffVec[3] = -tmp;
-
-    //********
-    // 4
-    //********
-    double sTmp5 = b6b7;
-    tmp = b1b5 * sTmp5;
-    double sTmp4 = b[5] * s67 + sTmp5;
-    tmp += b1b4 * sTmp4;
-    double sTmp3 = b[4] * s57 + sTmp4;
-    tmp += b1b3 * sTmp3;
-    double sTmp2 = b[3] * s47 + sTmp3;
-    tmp += b1b2 * sTmp2;
-
-    tmp += b2b5 * sTmp5;
-    tmp += b2b4 * sTmp4;
-    tmp += b2b3 * sTmp3;
-
-    tmp += b3b5 * sTmp5;
-    tmp += b3b4 * sTmp4;
-
-    tmp += b4b5 * sTmp5;
-
-    aPolyCoeffVec[4] = tmp;
-
-    //********
-    // 5
-    //********
-    double sTmpx3 = b4b5 * s67 + b4b6 * b[7]
-                               + b5b6 * b[7];
-
-    tmp = b1b2 * ( b3b4 * s57 + b3b5 * s67 + b3b6 * b[7] + sTmpx3 )
-        + b1b3 * sTmpx3
-        + b1b4 * b5b6 * b[7]
-        + b2b3 * sTmpx3
-        + b4b5 * b6b7 * ( b[2] + b[3] );
-
-    aPolyCoeffVec[5] = -tmp;
-
-    //********
-    // 6
-    //********
-    tmp = b1b2 * b3b4 * b5b6
-        + b1b2 * b3b4 * b5b7
-        + b1b2 * b3b4 * b6b7
-        + b1b2 * b3b5 * b6b7
-        + b1b2 * b4b5 * b6b7
-        + b1b3 * b4b5 * b6b7
-        + b2b3 * b4b5 * b6b7;
-
-    aPolyCoeffVec[6] = tmp;
-
-    //********
-    // 7
-    //********
-    tmp = b1b2 * b3b4 * b5b6 * b[7];
-
-    aPolyCoeffVec[7] = -tmp;
+//!************************************************************************
+//! Calculate the magnitude of the block filter at a given frequency
+//!
+//! @returns: |H(exp(j*2*pi*f/fs))|
+//!************************************************************************
+double NoisePwrSpectrum::calculateMagnitude
+    (
+    const std::vector<double>&  aBBlockCoeffVec,    //!< block filter coefficients (numerator)
+    const std::vector<double>&  aABlockCoeffVec,    //!< block filter coefficients (denominator)
+    const double                aFreqNorm           //!< frequency / sample rate
+    )
+{
+    const std::complex<double> zInv = std::polar( 1.0, -2.0 * M_PI * aFreqNorm );
+    double magnitude = 1;
+
+    for( size_t i = 0; i < aBBlockCoeffVec.size(); i++ )
+    {
+        magnitude *= std::abs( 1.0 - aBBlockCoeffVec[i] * zInv ) / std::abs( 1.0 - aABlockCoeffVec[i] * zInv );
+    }
+
+    return magnitude;
+}
+
+
+//!************************************************************************
+//! Design the filter for a set of parameters
+//!
+//! The amplitude normalization was fitted for the default design.
+//! Designs with other orders or pole densities are level matched
+//! to the default one at NORMALIZATION_FREQ_HZ.
+//!
+//! @returns: the normalized digital filter
+//!************************************************************************
+NoisePwrSpectrum::DigitalFilter NoisePwrSpectrum::designFilter
+    (
+    const FilterKey&    aKey        //!< filter design parameters
+    )
+{
+    std::vector<double> bBlockCoeffVec;
+    std::vector<double> aBlockCoeffVec;
+
+    calculateFilterBlockCoeffs( aKey, bBlockCoeffVec, aBlockCoeffVec );
+
+    std::vector<double> B;
+    std::vector<double> A;
+
+    calculateFilterPolyCoeffs( bBlockCoeffVec, B );
+    calculateFilterPolyCoeffs( aBlockCoeffVec, A );
+
+    double nCoeff = 1;
+
+    // N=7, h=1.1, c=0.30103, f=[20Hz..22.05kHz]
+    if( aKey.gamma < 0 )
+    {
+        nCoeff = 1 + 0.39 * pow( fabs( aKey.gamma ), 1.35845 );
+    }
+    else if( aKey.gamma > 0 )
+    {
+        nCoeff = 1 + 19 * pow( aKey.gamma, 4.39232 );
+    }
+
+    if( DEFAULT_NR_OF_FILTER_BLOCKS != aKey.nrOfBlocks
+     || DEFAULT_POLE_DENSITY != aKey.poleDensity
+      )
+    {
+        FilterKey defaultKey = aKey;
+        defaultKey.nrOfBlocks = DEFAULT_NR_OF_FILTER_BLOCKS;
+        defaultKey.poleDensity = DEFAULT_POLE_DENSITY;
+
+        std::vector<double> bDefaultBlockCoeffVec;
+        std::vector<double> aDefaultBlockCoeffVec;
+
+        calculateFilterBlockCoeffs( defaultKey, bDefaultBlockCoeffVec, aDefaultBlockCoeffVec );
+
+        const double FREQ_NORM = std::min( NORMALIZATION_FREQ_HZ / aKey.sampleRate, 0.25 );
+
+        nCoeff *= calculateMagnitude( bBlockCoeffVec, aBlockCoeffVec, FREQ_NORM )
+                / calculateMagnitude( bDefaultBlockCoeffVec, aDefaultBlockCoeffVec, FREQ_NORM );
+    }
+
+    for( size_t i = 0; i < B.size(); i++ )
+    {
+        B[i] /= nCoeff;
+    }
+
+    DigitalFilter filter;
+    filter.N = aKey.nrOfBlocks;
+    filter.b = B;
+    filter.a = A;
+    filter.bBlock = bBlockCoeffVec;
+    filter.aBlock = aBlockCoeffVec;
+    filter.gain = 1.0 / nCoeff;
+
+    return filter;
 }
 
 
@@ -257,45 +277,697 @@ void NoisePwrSpectrum::calculateFilterPolyCoeffs
 //!************************************************************************
 void NoisePwrSpectrum::filterData
     (
-    const std::vector<double>   aInSignal,       //!< input signal
+    const std::vector<double>&  aInSignal,       //!< input signal
     std::vector<double>&        aOutSignal       //!< output signal
     ) const
 {
-    size_t nrPoints = aInSignal.size();
-    
-    if( nrPoints )
+    forEachSegment( aInSignal.size(),
+                    [&]( const size_t aBegin, const size_t aEnd )
+                    {
+                        filterDataRange( aInSignal, aOutSignal, aBegin, aEnd );
+                    } );
+}
+
+
+//!************************************************************************
+//! Filter several signals at once, one per lane
+//!
+//! The filters must have the same number of blocks and the signals the
+//! same length. The state and coefficients of all lanes are interleaved,
+//! so that each step of the recursion is computed for every lane by the
+//! same vector instruction. Each lane gives the same output as filterData.
+//! Filters that cannot share lanes are applied one after another.
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoisePwrSpectrum::filterDataLanes
+    (
+    const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+    const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+    const std::vector<std::vector<double>*>&        aOutSignalVec   //!< output signals, one per lane
+    )
+{
+    bool canShareLanes = ( aFilterVec.size() > 1 && aFilterVec.size() <= MAX_LANES );
+
+    for( size_t l = 1; canShareLanes && l < aFilterVec.size(); l++ )
+    {
+        canShareLanes = ( aFilterVec[l]->mFilter.N == aFilterVec[0]->mFilter.N )
+                     && ( aInSignalVec[l]->size() == aInSignalVec[0]->size() );
+    }
+
+    if( canShareLanes )
+    {
+        forEachSegment( aInSignalVec[0]->size(),
+                        [&]( const size_t aBegin, const size_t aEnd )
+                        {
+                            filterDataLanesRange( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+                        } );
+    }
+    else
     {
-        std::vector<double> coeffVec( 1 + mFilter.N );
-        
+        for( size_t l = 0; l < aFilterVec.size(); l++ )
+        {
+            aFilterVec[l]->filterData( *aInSignalVec[l], *aOutSignalVec[l] );
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Filter a range of several signals at once, one per lane
+//! The range must start on a multiple of FILTER_RESET_PERIOD.
+//!
+//! Only the orders compiled as fixed size specializations are filtered
+//! in lanes; the other orders are filtered lane by lane.
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoisePwrSpectrum::filterDataLanesRange
+    (
+    const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+    const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+    const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+    const size_t                                    aBegin,         //!< index of the first sample
+    const size_t                                    aEnd            //!< index after the last sample
+    )
+{
+    switch( aFilterVec[0]->mFilter.N )
+    {
+        case 3:
+            filterDataLanesOrder<3>( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+            break;
+
+        case 5:
+            filterDataLanesOrder<5>( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+            break;
+
+        case 7:
+            filterDataLanesOrder<7>( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+            break;
+
+        case 9:
+            filterDataLanesBlocks<9>( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+            break;
+
+        case 11:
+            filterDataLanesBlocks<11>( aFilterVec, aInSignalVec, aOutSignalVec, aBegin, aEnd );
+            break;
+
+        default:
+            for( size_t l = 0; l < aFilterVec.size(); l++ )
+            {
+                aFilterVec[l]->filterDataRange( *aInSignalVec[l], *aOutSignalVec[l], aBegin, aEnd );
+            }
+            break;
+    }
+}
+
+
+//!************************************************************************
+//! Filter a range of the provided signal
+//! The range must start on a multiple of FILTER_RESET_PERIOD.
+//!
+//! Up to MAX_DIRECT_FORM_ORDER, the polynomial (direct) form is used.
+//! For higher orders the poles get too close to 1 for the expanded
+//! polynomials to stay accurate, so the first order blocks are chained.
+//! The orders most often used are compiled as specializations with
+//! fixed size state, so that the inner loops are fully unrolled.
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoisePwrSpectrum::filterDataRange
+    (
+    const std::vector<double>&  aInSignal,      //!< input signal
+    std::vector<double>&        aOutSignal,     //!< output signal
+    const size_t                aBegin,         //!< index of the first sample
+    const size_t                aEnd            //!< index after the last sample
+    ) const
+{
+    switch( mFilter.N )
+    {
+        case 3:
+            filterDataOrder<3>( aInSignal, aOutSignal, aBegin, aEnd );
+            break;
+
+        case 5:
+            filterDataOrder<5>( aInSignal, aOutSignal, aBegin, aEnd );
+            break;
+
+        case 7:
+            filterDataOrder<7>( aInSignal, aOutSignal, aBegin, aEnd );
+            break;
+
+        case 9:
+            filterDataBlocks<9>( aInSignal, aOutSignal, aBegin, aEnd );
+            break;
+
+        case 11:
+            filterDataBlocks<11>( aInSignal, aOutSignal, aBegin, aEnd );
+            break;
+
+        default:
+            if( mFilter.N <= MAX_DIRECT_FORM_ORDER )
+            {
+                double coeffVec[MAX_DIRECT_FORM_ORDER + 1] = {};
+
+                for( size_t i = aBegin; i < aEnd; i++ )
+                {
+                    if( 0 == i % FILTER_RESET_PERIOD )
+                    {
+                        std::fill( coeffVec, coeffVec + 1 + mFilter.N, 0 );
+                    }
+
+                    int j = 0;
+
+                    for( j = mFilter.N; j >= 1; j-- )
+                    {
+                        coeffVec[j] = coeffVec[j - 1];
+                    }
+
+                    coeffVec[0] = aInSignal[i];
+
+                    for( j = 1; j <= mFilter.N; j++ )
+                    {
+                        coeffVec[0] -= mFilter.a[j] * coeffVec[j];
+                    }
+
+                    aOutSignal[i] = 0;
+
+                    for( j = 0; j <= mFilter.N; j++ )
+                    {
+                        aOutSignal[i] += mFilter.b[j] * coeffVec[j];
+                    }
+                }
+            }
+            else
+            {
+                double stateVec[MAX_NR_OF_FILTER_BLOCKS] = {};
+
+                for( size_t i = aBegin; i < aEnd; i++ )
+                {
+                    if( 0 == i % FILTER_RESET_PERIOD )
+                    {
+                        std::fill( stateVec, stateVec + mFilter.N, 0 );
+                    }
+
+                    double y = aInSignal[i];
+
+                    for( int k = 0; k < mFilter.N; k++ )
+                    {
+                        double w = y + mFilter.aBlock[k] * stateVec[k];
+                        y = w - mFilter.bBlock[k] * stateVec[k];
+                        stateVec[k] = w;
+                    }
+
+                    aOutSignal[i] = mFilter.gain * y;
+                }
+            }
+            break;
+    }
+}
+
+
+//!************************************************************************
+//! Filter the provided signal with N chained first order blocks,
+//! N known at compile time
+//!
+//! @returns: nothing
+//!************************************************************************
+template<int N>
+void NoisePwrSpectrum::filterDataBlocks
+    (
+    const std::vector<double>&  aInSignal,      //!< input signal
+    std::vector<double>&        aOutSignal,     //!< output signal
+    const size_t                aBegin,         //!< index of the first sample
+    const size_t                aEnd            //!< index after the last sample
+    ) const
+{
+    double a[N];
+    double b[N];
+    double stateVec[N] = {};
+
+    std::copy( mFilter.aBlock.begin(), mFilter.aBlock.end(), a );
+    std::copy( mFilter.bBlock.begin(), mFilter.bBlock.end(), b );
+
+    for( size_t i = aBegin; i < aEnd; i++ )
+    {
+        if( 0 == i % FILTER_RESET_PERIOD )
+        {
+            std::fill( stateVec, stateVec + N, 0 );
+        }
+
+        double y = aInSignal[i];
+
+        for( int k = 0; k < N; k++ )
+        {
+            double w = y + a[k] * stateVec[k];
+            y = w - b[k] * stateVec[k];
+            stateVec[k] = w;
+        }
+
+        aOutSignal[i] = mFilter.gain * y;
+    }
+}
+
+
+//!************************************************************************
+//! Filter the provided signal with a filter of order N known at compile time
+//!
+//! @returns: nothing
+//!************************************************************************
+template<int N>
+void NoisePwrSpectrum::filterDataOrder
+    (
+    const std::vector<double>&  aInSignal,      //!< input signal
+    std::vector<double>&        aOutSignal,     //!< output signal
+    const size_t                aBegin,         //!< index of the first sample
+    const size_t                aEnd            //!< index after the last sample
+    ) const
+{
+    double a[N + 1];
+    double b[N + 1];
+    double coeffVec[N + 1] = {};
+
+    std::copy( mFilter.a.begin(), mFilter.a.end(), a );
+    std::copy( mFilter.b.begin(), mFilter.b.end(), b );
+
+    for( size_t i = aBegin; i < aEnd; i++ )
+    {
+        if( 0 == i % FILTER_RESET_PERIOD )
+        {
+            std::fill( coeffVec, coeffVec + N + 1, 0 );
+        }
+
+        for( int j = N; j >= 1; j-- )
+        {
+            coeffVec[j] = coeffVec[j - 1];
+        }
+
+        coeffVec[0] = aInSignal[i];
+
+        for( int j = 1; j <= N; j++ )
+        {
+            coeffVec[0] -= a[j] * coeffVec[j];
+        }
+
+        double y = 0;
+
+        for( int j = 0; j <= N; j++ )
+        {
+            y += b[j] * coeffVec[j];
+        }
+
+        aOutSignal[i] = y;
+    }
+}
+
+
+//!************************************************************************
+//! Filter several signals at once with N chained first order blocks,
+//! N known at compile time
+//!
+//! Each reset period of all lanes is first interleaved into a local
+//! [sample][lane] buffer. With the state and coefficients stored as
+//! [block][lane], every step of the recursion is the same operation on
+//! MAX_LANES contiguous values, which the compiler turns into vector
+//! instructions. Each lane follows the arithmetic of filterDataBlocks.
+//! Unused lanes are fed with zeros.
+//!
+//! @returns: nothing
+//!************************************************************************
+template<int N>
+void NoisePwrSpectrum::filterDataLanesBlocks
+    (
+    const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+    const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+    const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+    const size_t                                    aBegin,         //!< index of the first sample
+    const size_t                                    aEnd            //!< index after the last sample
+    )
+{
+    const size_t nrOfLanes = aFilterVec.size();
+
+    double a[N][MAX_LANES] = {};
+    double b[N][MAX_LANES] = {};
+    double gain[MAX_LANES] = {};
+    double laneData[FILTER_RESET_PERIOD][MAX_LANES] = {};
+
+    for( size_t l = 0; l < nrOfLanes; l++ )
+    {
+        for( int k = 0; k < N; k++ )
+        {
+            a[k][l] = aFilterVec[l]->mFilter.aBlock[k];
+            b[k][l] = aFilterVec[l]->mFilter.bBlock[k];
+        }
+
+        gain[l] = aFilterVec[l]->mFilter.gain;
+    }
+
+    for( size_t begin = aBegin; begin < aEnd; begin += FILTER_RESET_PERIOD )
+    {
+        const size_t nrPoints = std::min( begin + FILTER_RESET_PERIOD, aEnd ) - begin;
+
+        for( size_t l = 0; l < nrOfLanes; l++ )
+        {
+            const double* inData = aInSignalVec[l]->data() + begin;
+
+            for( size_t i = 0; i < nrPoints; i++ )
+            {
+                laneData[i][l] = inData[i];
+            }
+        }
+
+        double stateVec[N][MAX_LANES] = {};
+
+        for( size_t i = 0; i < nrPoints; i++ )
+        {
+            double y[MAX_LANES];
+
+            for( size_t l = 0; l < MAX_LANES; l++ )
+            {
+                y[l] = laneData[i][l];
+            }
+
+            for( int k = 0; k < N; k++ )
+            {
+                for( size_t l = 0; l < MAX_LANES; l++ )
+                {
+                    double w = y[l] + a[k][l] * stateVec[k][l];
+                    y[l] = w - b[k][l] * stateVec[k][l];
+                    stateVec[k][l] = w;
+                }
+            }
+
+            for( size_t l = 0; l < MAX_LANES; l++ )
+            {
+                laneData[i][l] = gain[l] * y[l];
+            }
+        }
+
+        for( size_t l = 0; l < nrOfLanes; l++ )
+        {
+            double* outData = aOutSignalVec[l]->data() + begin;
+
+            for( size_t i = 0; i < nrPoints; i++ )
+            {
+                outData[i] = laneData[i][l];
+            }
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Filter several signals at once with a filter of order N known at
+//! compile time
+//!
+//! Same layout as filterDataLanesBlocks. Each lane follows the arithmetic
+//! of filterDataOrder.
+//!
+//! @returns: nothing
+//!************************************************************************
+template<int N>
+void NoisePwrSpectrum::filterDataLanesOrder
+    (
+    const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+    const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+    const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+    const size_t                                    aBegin,         //!< index of the first sample
+    const size_t                                    aEnd            //!< index after the last sample
+    )
+{
+    const size_t nrOfLanes = aFilterVec.size();
+
+    double a[N + 1][MAX_LANES] = {};
+    double b[N + 1][MAX_LANES] = {};
+    double laneData[FILTER_RESET_PERIOD][MAX_LANES] = {};
+
+    for( size_t l = 0; l < nrOfLanes; l++ )
+    {
+        for( int j = 0; j <= N; j++ )
+        {
+            a[j][l] = aFilterVec[l]->mFilter.a[j];
+            b[j][l] = aFilterVec[l]->mFilter.b[j];
+        }
+    }
+
+    for( size_t begin = aBegin; begin < aEnd; begin += FILTER_RESET_PERIOD )
+    {
+        const size_t nrPoints = std::min( begin + FILTER_RESET_PERIOD, aEnd ) - begin;
+
+        for( size_t l = 0; l < nrOfLanes; l++ )
+        {
+            const double* inData = aInSignalVec[l]->data() + begin;
+
+            for( size_t i = 0; i < nrPoints; i++ )
+            {
+                laneData[i][l] = inData[i];
+            }
+        }
+
+        double coeffVec[N + 1][MAX_LANES] = {};
+
         for( size_t i = 0; i < nrPoints; i++ )
         {
-            if( 0 == i % 512 )
+            for( int j = N; j >= 1; j-- )
+            {
+                for( size_t l = 0; l < MAX_LANES; l++ )
+                {
+                    coeffVec[j][l] = coeffVec[j - 1][l];
+                }
+            }
+
+            for( size_t l = 0; l < MAX_LANES; l++ )
             {
-                std::fill( coeffVec.begin(), coeffVec.end(), 0 );
+                coeffVec[0][l] = laneData[i][l];
             }
 
-            int j = 0;
-            
-            for( j = mFilter.N; j >= 1; j-- )
+            for( int j = 1; j <= N; j++ )
             {
-                coeffVec[j] = coeffVec[j - 1];
+                for( size_t l = 0; l < MAX_LANES; l++ )
+                {
+                    coeffVec[0][l] -= a[j][l] * coeffVec[j][l];
+                }
             }
 
-            coeffVec[0] = aInSignal[i];
+            double y[MAX_LANES] = {};
+
+            for( int j = 0; j <= N; j++ )
+            {
+                for( size_t l = 0; l < MAX_LANES; l++ )
+                {
+                    y[l] += b[j][l] * coeffVec[j][l];
+                }
+            }
 
-            for( j = 1; j <= mFilter.N; j++ )
+            for( size_t l = 0; l < MAX_LANES; l++ )
             {
-                coeffVec[0] -= mFilter.a[j] * coeffVec[j];
+                laneData[i][l] = y[l];
             }
+        }
+
+        for( size_t l = 0; l < nrOfLanes; l++ )
+        {
+            double* outData = aOutSignalVec[l]->data() + begin;
+
+            for( size_t i = 0; i < nrPoints; i++ )
+            {
+                outData[i] = laneData[i][l];
+            }
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Run a function over the segments of a signal
+//!
+//! The filter state is cleared every FILTER_RESET_PERIOD samples, so
+//! segments starting on such a boundary are independent of each other.
+//! Long signals are split into aligned segments processed concurrently,
+//! which gives the same output as a serial pass.
+//! At most getMaxThreads() threads are used. The function is a template
+//! parameter, so a short signal is processed without any allocation.
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename Function>
+void NoisePwrSpectrum::forEachSegment
+    (
+    const size_t    aNrPoints,  //!< number of samples
+    const Function& aFunction   //!< function called with [begin, end)
+    )
+{
+    size_t nrThreads = 1;
+
+    if( aNrPoints >= MIN_PARALLEL_POINTS )
+    {
+        nrThreads = getMaxThreads();
+
+        if( 0 == nrThreads )
+        {
+            nrThreads = std::thread::hardware_concurrency();
+        }
+    }
 
-            aOutSignal[i] = 0;
-    
-            for( j = 0; j <= mFilter.N; j++ )
+    if( nrThreads < 2 )
+    {
+        aFunction( 0, aNrPoints );
+    }
+    else
+    {
+        nrThreads = std::min( nrThreads, aNrPoints / FILTER_RESET_PERIOD );
+
+        size_t segmentPoints = ( aNrPoints + nrThreads - 1 ) / nrThreads;
+        segmentPoints = FILTER_RESET_PERIOD * ( ( segmentPoints + FILTER_RESET_PERIOD - 1 ) / FILTER_RESET_PERIOD );
+
+        std::vector<std::thread> threadVec;
+
+        for( size_t begin = segmentPoints; begin < aNrPoints; begin += segmentPoints )
+        {
+            const size_t end = std::min( begin + segmentPoints, aNrPoints );
+            threadVec.emplace_back( aFunction, begin, end );
+        }
+
+        aFunction( 0, std::min( segmentPoints, aNrPoints ) );
+
+        for( auto& crtThread : threadVec )
+        {
+            crtThread.join();
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Get the filter for a set of parameters from the process-wide cache
+//!
+//! The cache is keyed by (gamma, sample rate, number of blocks, pole density).
+//! On the first request for a design, the filters for the whole gamma grid
+//! [GAMMA_MIN..GAMMA_MAX] with GAMMA_STEP are designed at once, so later
+//! gamma changes made through the UI are lookups. Values off the grid are
+//! designed on demand and cached as well. Up to MAX_GRID_DESIGNS grids and
+//! MAX_OFF_GRID_FILTERS off-grid filters are kept; beyond that the least
+//! recently used grid or filter is dropped, so the cache stays bounded
+//! whatever designs are requested.
+//!
+//! @returns: the normalized digital filter
+//!************************************************************************
+NoisePwrSpectrum::DigitalFilter NoisePwrSpectrum::getFilter
+    (
+    const FilterKey&    aKey        //!< filter design parameters
+    )
+{
+    static std::mutex cacheMutex;
+    static std::map<FilterKey, DigitalFilter> filterCache;
+    static std::list<FilterKey> gridKeyList;        // most recently used first
+    static std::list<FilterKey> offGridKeyList;     // most recently used first
+    static std::map<FilterKey, std::list<FilterKey>::iterator> offGridKeyMap;
+
+    const double STEPS_PER_UNIT = round( 1.0 / GAMMA_STEP );
+    const int NR_OF_STEPS = static_cast<int>( lround( ( GAMMA_MAX - GAMMA_MIN ) * STEPS_PER_UNIT ) );
+
+    std::lock_guard<std::mutex> lock( cacheMutex );
+
+    FilterKey gridKey = aKey;
+    gridKey.gamma = 0;
+
+    auto gridIt = std::find_if( gridKeyList.begin(), gridKeyList.end(),
+                                [&]( const FilterKey& aGridKey ) { return !( aGridKey < gridKey ) && !( gridKey < aGridKey ); } );
+
+    if( gridKeyList.end() != gridIt )
+    {
+        gridKeyList.splice( gridKeyList.begin(), gridKeyList, gridIt );
+    }
+    else
+    {
+        if( gridKeyList.size() >= MAX_GRID_DESIGNS )
+        {
+            for( int i = 0; i <= NR_OF_STEPS; i++ )
             {
-                aOutSignal[i] += mFilter.b[j] * coeffVec[j];
+                FilterKey crtKey = gridKeyList.back();
+                crtKey.gamma = ( GAMMA_MIN * STEPS_PER_UNIT + i ) / STEPS_PER_UNIT;
+                filterCache.erase( crtKey );
             }
+
+            gridKeyList.pop_back();
+        }
+
+        for( int i = 0; i <= NR_OF_STEPS; i++ )
+        {
+            // same double values as the ones entered with 2 decimals
+            FilterKey crtKey = aKey;
+            crtKey.gamma = ( GAMMA_MIN * STEPS_PER_UNIT + i ) / STEPS_PER_UNIT;
+            filterCache[crtKey] = designFilter( crtKey );
+        }
+
+        gridKeyList.push_front( gridKey );
+    }
+
+    auto it = filterCache.find( aKey );
+
+    if( filterCache.end() == it )
+    {
+        if( offGridKeyList.size() >= MAX_OFF_GRID_FILTERS )
+        {
+            filterCache.erase( offGridKeyList.back() );
+            offGridKeyMap.erase( offGridKeyList.back() );
+            offGridKeyList.pop_back();
+        }
+
+        offGridKeyList.push_front( aKey );
+        offGridKeyMap[aKey] = offGridKeyList.begin();
+        it = filterCache.insert( std::make_pair( aKey, designFilter( aKey ) ) ).first;
+    }
+    else
+    {
+        auto offGridIt = offGridKeyMap.find( aKey );
+
+        if( offGridKeyMap.end() != offGridIt )
+        {
+            offGridKeyList.splice( offGridKeyList.begin(), offGridKeyList, offGridIt->second );
         }
     }
+
+    return it->second;
+}
+
+
+//!************************************************************************
+//! Get the magnitude of the filter frequency response
+//!
+//! @returns: |H(f)|
+//!************************************************************************
+double NoisePwrSpectrum::getMagnitude
+    (
+    const double aFreqHz        //!< frequency [Hz]
+    ) const
+{
+    return mFilter.gain * calculateMagnitude( mFilter.bBlock, mFilter.aBlock, aFreqHz / mSampleRate );
+}
+
+
+//!************************************************************************
+//! Get the process-wide limit of threads used for filtering one signal
+//!
+//! @returns: the limit, 0 for hardware concurrency
+//!************************************************************************
+std::atomic<unsigned>& NoisePwrSpectrum::getMaxThreads()
+{
+    static std::atomic<unsigned> maxThreads( 0 );
+
+    return maxThreads;
+}
+
+
+//!************************************************************************
+//! Get the number of filter blocks
+//!
+//! @returns: the filter order
+//!************************************************************************
+int NoisePwrSpectrum::getNrOfBlocks() const
+{
+    return mNrOfBlocks;
 }
 
 
@@ -315,42 +987,39 @@ void NoisePwrSpectrum::setGamma
     {
         mGamma = aGamma;
 
-        calculateFilterBlockCoeffs();
         updateFilter();
     }
 }
 
 
 //!************************************************************************
-//! Update the filter parameters
+//! Set the process-wide limit of threads used for filtering one signal
+//! Callers which already run several renders concurrently lower it,
+//! so that the machine is not oversubscribed.
 //!
 //! @returns: nothing
 //!************************************************************************
-void NoisePwrSpectrum::updateFilter()
+void NoisePwrSpectrum::setMaxThreads
+    (
+    const unsigned aMaxThreads  //!< maximum number of threads, 0 for hardware concurrency
+    )
 {
-    std::vector<double> B( NR_OF_FILTER_BLOCKS + 1 );
-    std::vector<double> A( NR_OF_FILTER_BLOCKS + 1 );
-
-    calculateFilterPolyCoeffs( mBBlockCoeffVec, B );
-    calculateFilterPolyCoeffs( mABlockCoeffVec, A );
-
-    double nCoeff = 1;
+    getMaxThreads() = aMaxThreads;
+}
 
-    // N=7, h=1.1, c=0.30103, f=[20Hz..22.05kHz]
-    if( mGamma < 0 )
-    {
-        nCoeff = 1 + 0.39 * pow( fabs( mGamma ), 1.35845 );
-    }
-    else if( mGamma > 0 )
-    {
-        nCoeff = 1 + 19 * pow( mGamma, 4.39232 );
-    }
 
-    for( size_t i = 0; i < B.size(); i++ )
-    {
-        B[i] /= nCoeff;
-    }
+//!************************************************************************
+//! Update the filter parameters
+//!
+//! @returns: nothing
+//!************************************************************************
+void NoisePwrSpectrum::updateFilter()
+{
+    FilterKey key;
+    key.gamma = mGamma;
+    key.sampleRate = mSampleRate;
+    key.nrOfBlocks = mNrOfBlocks;
+    key.poleDensity = mPoleDensity;
 
-    mFilter.b = B;
-    mFilter.a = A;   
+    mFilter = getFilter( key );
 }
@@ -24,7 +24,10 @@ This file contains the definitions for the noise power spectral density.
 #define NoisePwrSpectrum_h
 
 #include <vector>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <tuple>
 
 
 //************************************************************************
@@ -49,19 +52,61 @@ class NoisePwrSpectrum
 
         static constexpr double GAMMA_MIN = -2;     //!< minimum frequency exponent
         static constexpr double GAMMA_MAX = 2;      //!< maxium frequency exponent
+        static constexpr double GAMMA_STEP = 0.01;  //!< step of the precomputed gamma grid
+
+        static const uint32_t DEFAULT_SAMPLE_RATE = 44100;  //!< default sample rate [Hz]
+
+        static const int DEFAULT_NR_OF_FILTER_BLOCKS = 7;       //!< N = default number of digital filter blocks
+        static const int MIN_NR_OF_FILTER_BLOCKS = 1;           //!< minimum number of digital filter blocks
+        static const int MAX_NR_OF_FILTER_BLOCKS = 16;          //!< maximum number of digital filter blocks
+
+        static constexpr double DEFAULT_POLE_DENSITY = 1.1;     //!< default number of poles / decade
+        static constexpr double MIN_POLE_DENSITY = 0.5;         //!< minimum number of poles / decade
+        static constexpr double MAX_POLE_DENSITY = 4;           //!< maximum number of poles / decade
+
+        static const int FILTER_RESET_PERIOD = 512;             //!< number of samples after which the filter state is cleared
+
+        static const size_t MAX_LANES = 4;                      //!< number of signals filtered together by filterDataLanes
+
+        static const size_t MAX_GRID_DESIGNS = 8;               //!< gamma grids (sample rate, blocks, pole density) kept by the filter cache
+        static const size_t MAX_OFF_GRID_FILTERS = 64;          //!< designs of gammas off the grid kept by the filter cache
 
     private:
-        static const int NR_OF_FILTER_BLOCKS = 7;    //!< N = number of digital filter blocks
+        static const int MAX_DIRECT_FORM_ORDER = DEFAULT_NR_OF_FILTER_BLOCKS;  //!< higher orders are filtered block by block
+        static const size_t MIN_PARALLEL_POINTS = 1 << 17;      //!< shorter signals are filtered by a single thread
+
+        static constexpr double NORMALIZATION_FREQ_HZ = 1000;   //!< frequency where designs of any order are level matched
 
         struct DigitalFilter
         {
             int                     N;      //!< degree
             std::vector<double>     b;      //!< poly filter coeffs (numerator)
             std::vector<double>     a;      //!< poly filter coeffs (denominator)
+            std::vector<double>     bBlock; //!< block filter coeffs (numerator)
+            std::vector<double>     aBlock; //!< block filter coeffs (denominator)
+            double                  gain;   //!< gain of the block filter
 
             DigitalFilter()
             {
-                N = NR_OF_FILTER_BLOCKS;
+                N = DEFAULT_NR_OF_FILTER_BLOCKS;
+                gain = 1;
+            }
+        };
+
+        struct FilterKey
+        {
+            double      gamma;          //!< frequency exponent
+            uint32_t    sampleRate;     //!< sample rate [Hz]
+            int         nrOfBlocks;     //!< number of filter blocks
+            double      poleDensity;    //!< number of poles / decade
+
+            bool operator<
+                (
+                const FilterKey& aKey   //!< other key
+                ) const
+            {
+                return std::tie( gamma, sampleRate, nrOfBlocks, poleDensity )
+                     < std::tie( aKey.gamma, aKey.sampleRate, aKey.nrOfBlocks, aKey.poleDensity );
             }
         };
 
@@ -72,31 +117,139 @@ class NoisePwrSpectrum
     public:
         NoisePwrSpectrum
             (
-            double aGamma   //!< frequency exponent
+            double      aGamma,                                         //!< frequency exponent
+            uint32_t    aSampleRate = DEFAULT_SAMPLE_RATE,              //!< sample rate [Hz]
+            int         aNrOfBlocks = DEFAULT_NR_OF_FILTER_BLOCKS,      //!< number of filter blocks
+            double      aPoleDensity = DEFAULT_POLE_DENSITY             //!< number of poles / decade
             );
 
         ~NoisePwrSpectrum();
     
         void filterData
             (
-            const std::vector<double>   aInSignal,   //!< input signal
+            const std::vector<double>&  aInSignal,   //!< input signal
             std::vector<double>&        aOutSignal   //!< output signal
             ) const;
 
+        static void filterDataLanes
+            (
+            const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+            const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+            const std::vector<std::vector<double>*>&        aOutSignalVec   //!< output signals, one per lane
+            );
+
+        double getMagnitude
+            (
+            const double aFreqHz        //!< frequency [Hz]
+            ) const;
+
+        int getNrOfBlocks() const;
+
         void setGamma
             (
             const double aGamma         //!< frequency exponent
             );
 
+        static void setMaxThreads
+            (
+            const unsigned aMaxThreads  //!< maximum number of threads, 0 for hardware concurrency
+            );
+
     private:
-        void calculateFilterBlockCoeffs();
+        static void calculateFilterBlockCoeffs
+            (
+            const FilterKey&        aKey,               //!< filter design parameters
+            std::vector<double>&    aBBlockCoeffVec,    //!< block filter coefficients (numerator)
+            std::vector<double>&    aABlockCoeffVec     //!< block filter coefficients (denominator)
+            );
 
-        void calculateFilterPolyCoeffs
+        static void calculateFilterPolyCoeffs
             (
-            const std::vector<double>   aBlockCoeffVec,     //!< block filter coefficients
+            const std::vector<double>&  aBlockCoeffVec,     //!< block filter coefficients
             std::vector<double>&        aPolyCoeffVec       //!< poly filter coefficients
             );
 
+        static double calculateMagnitude
+            (
+            const std::vector<double>&  aBBlockCoeffVec,    //!< block filter coefficients (numerator)
+            const std::vector<double>&  aABlockCoeffVec,    //!< block filter coefficients (denominator)
+            const double                aFreqNorm           //!< frequency / sample rate
+            );
+
+        static DigitalFilter designFilter
+            (
+            const FilterKey&    aKey        //!< filter design parameters
+            );
+
+        template<int N>
+        void filterDataBlocks
+            (
+            const std::vector<double>&  aInSignal,  //!< input signal
+            std::vector<double>&        aOutSignal, //!< output signal
+            const size_t                aBegin,     //!< index of the first sample
+            const size_t                aEnd        //!< index after the last sample
+            ) const;
+
+        template<int N>
+        void filterDataOrder
+            (
+            const std::vector<double>&  aInSignal,  //!< input signal
+            std::vector<double>&        aOutSignal, //!< output signal
+            const size_t                aBegin,     //!< index of the first sample
+            const size_t                aEnd        //!< index after the last sample
+            ) const;
+
+        template<int N>
+        static void filterDataLanesBlocks
+            (
+            const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+            const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+            const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+            const size_t                                    aBegin,         //!< index of the first sample
+            const size_t                                    aEnd            //!< index after the last sample
+            );
+
+        template<int N>
+        static void filterDataLanesOrder
+            (
+            const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+            const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+            const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+            const size_t                                    aBegin,         //!< index of the first sample
+            const size_t                                    aEnd            //!< index after the last sample
+            );
+
+        static void filterDataLanesRange
+            (
+            const std::vector<const NoisePwrSpectrum*>&     aFilterVec,     //!< filters, one per lane
+            const std::vector<const std::vector<double>*>&  aInSignalVec,   //!< input signals, one per lane
+            const std::vector<std::vector<double>*>&        aOutSignalVec,  //!< output signals, one per lane
+            const size_t                                    aBegin,         //!< index of the first sample
+            const size_t                                    aEnd            //!< index after the last sample
+            );
+
+        void filterDataRange
+            (
+            const std::vector<double>&  aInSignal,  //!< input signal
+            std::vector<double>&        aOutSignal, //!< output signal
+            const size_t                aBegin,     //!< index of the first sample
+            const size_t                aEnd        //!< index after the last sample
+            ) const;
+
+        template<typename Function>
+        static void forEachSegment
+            (
+            const size_t    aNrPoints,  //!< number of samples
+            const Function& aFunction   //!< function called with [begin, end)
+            );
+
+        static DigitalFilter getFilter
+            (
+            const FilterKey&    aKey        //!< filter design parameters
+            );
+
+        static std::atomic<unsigned>& getMaxThreads();
+
         void updateFilter();
 
 
@@ -105,9 +258,9 @@ class NoisePwrSpectrum
     //************************************************************************
     private:
         double                  mGamma;             //!< frequency exponent
-
-        std::vector<double>     mBBlockCoeffVec;    //!< filter coefficients for all z^(-1) blocks (numerator)
-        std::vector<double>     mABlockCoeffVec;    //!< filter coefficients for all z^(-1) blocks (denominator)
+        uint32_t                mSampleRate;        //!< sample rate [Hz]
+        int                     mNrOfBlocks;        //!< number of filter blocks
+        double                  mPoleDensity;       //!< number of poles / decade
 
         DigitalFilter           mFilter;            //!< filter
 };
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+PinkNoise.cpp
+This file contains the sources for the pink noise generator.
+*/
+
+#include "PinkNoise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+
+const int PinkNoise::UPDATE_PERIOD;
+
+
+//!************************************************************************
+//! Constructor
+//!
+//! The gain is chosen so that, on average over the matching band, the
+//! output has the same level as the IIR filter designed for gamma = 1.
+//! Switching between the two engines then does not change the loudness.
+//!************************************************************************
+PinkNoise::PinkNoise
+    (
+    uint32_t    aSampleRate     //!< sample rate [Hz]
+    )
+    : mGain( 1 )
+{
+    reset();
+
+    if( 0 == aSampleRate )
+    {
+        aSampleRate = NoisePwrSpectrum::DEFAULT_SAMPLE_RATE;
+    }
+
+    NoisePwrSpectrum noisePwrSpectrum( GAMMA, aSampleRate );
+
+    const double freqMax = std::min( MATCH_FREQ_MAX_HZ, 0.45 * aSampleRate );
+    const double freqRatio = pow( freqMax / MATCH_FREQ_MIN_HZ, 1.0 / ( NR_OF_MATCH_FREQS - 1 ) );
+
+    double freq = MATCH_FREQ_MIN_HZ;
+    double logRatioSum = 0;
+
+    for( int i = 0; i < NR_OF_MATCH_FREQS; i++ )
+    {
+        double magnitude = noisePwrSpectrum.getMagnitude( freq );
+        logRatioSum += log( magnitude * magnitude / calculatePowerSpectrum( freq / aSampleRate ) );
+        freq *= freqRatio;
+    }
+
+    mGain = sqrt( exp( logRatioSum / NR_OF_MATCH_FREQS ) );
+}
+
+
+//!************************************************************************
+//! Calculate the power spectral density of the row update scheme
+//! for a white input of unit variance
+//!
+//! The input samples assigned to row k occur every L = 2^(k+1) samples.
+//! Each of them is seen once directly and then held for L samples, so its
+//! contribution is (1/L) * |1 + sum_{j<L} exp(-i*2*pi*f*j)|^2.
+//!
+//! @returns: the power spectral density
+//!************************************************************************
+double PinkNoise::calculatePowerSpectrum
+    (
+    const double    aFreqNorm       //!< frequency / sample rate
+    )
+{
+    const std::complex<double> zInv = std::polar( 1.0, -2.0 * M_PI * aFreqNorm );
+    double psd = 0;
+
+    for( int k = 0; k < NR_OF_ROWS; k++ )
+    {
+        const int holdLength = std::min( 2 << k, UPDATE_PERIOD );
+        std::complex<double> response = 1;
+        std::complex<double> zPow = 1;
+
+        for( int j = 0; j < holdLength; j++ )
+        {
+            response += zPow;
+            zPow *= zInv;
+        }
+
+        psd += std::norm( response ) / holdLength;
+    }
+
+    return psd;
+}
+
+
+//!************************************************************************
+//! Filter the provided signal
+//!
+//! Within every UPDATE_PERIOD samples, row k is updated at the indexes
+//! having k trailing zeros and the last row at the period boundary, so
+//! each row holds an input sample for at most UPDATE_PERIOD samples.
+//! The running sum of the rows is recomputed at every period boundary,
+//! so rounding errors do not accumulate over long signals.
+//! The length of a chunk, except for the last one, must be a multiple
+//! of UPDATE_PERIOD.
+//!
+//! @returns: nothing
+//!************************************************************************
+void PinkNoise::filterData
+    (
+    const std::vector<double>&  aInSignal,       //!< input signal
+    std::vector<double>&        aOutSignal       //!< output signal
+    )
+{
+    double rowSum = 0;
+
+    for( int k = 0; k < NR_OF_ROWS; k++ )
+    {
+        rowSum += mRowVec[k];
+    }
+
+    for( size_t i = 0; i < aInSignal.size(); i++ )
+    {
+        size_t phase = i % UPDATE_PERIOD;
+        int row = 0;
+
+        if( 0 == phase )
+        {
+            row = NR_OF_ROWS - 1;
+            rowSum = 0;
+
+            for( int k = 0; k < NR_OF_ROWS; k++ )
+            {
+                rowSum += mRowVec[k];
+            }
+        }
+        else
+        {
+            while( 0 == ( phase & 1 ) )
+            {
+                phase >>= 1;
+                row++;
+            }
+        }
+
+        rowSum += aInSignal[i] - mRowVec[row];
+        mRowVec[row] = aInSignal[i];
+
+        aOutSignal[i] = mGain * ( rowSum + aInSignal[i] );
+    }
+}
+
+
+//!************************************************************************
+//! Clear the rows, for starting a new signal
+//!
+//! @returns: nothing
+//!************************************************************************
+void PinkNoise::reset()
+{
+    std::fill( mRowVec, mRowVec + NR_OF_ROWS, 0 );
+}
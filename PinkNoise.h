@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+PinkNoise.h
+This file contains the definitions for the pink noise generator.
+*/
+
+#ifndef PinkNoise_h
+#define PinkNoise_h
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "NoisePwrSpectrum.h"
+
+
+//************************************************************************
+// Class for shaping white noise into pink (1/f) noise with the
+// Voss-McCartney row update scheme
+//
+// Each input sample replaces one of the held rows, the row being given
+// by the number of trailing zeros of the sample index, so row k is
+// refreshed every 2^(k+1) samples. The output is the sum of the rows and
+// of the current input sample, which costs a few additions per sample
+// instead of a full IIR recursion. The rows are kept between calls, so a
+// long signal can be filtered in consecutive chunks.
+//************************************************************************
+class PinkNoise
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static constexpr double GAMMA = 1;          //!< frequency exponent of the generated noise
+
+    private:
+        static const int UPDATE_PERIOD = NoisePwrSpectrum::FILTER_RESET_PERIOD;   //!< longest row hold time [samples]
+        static const int NR_OF_ROWS = 10;           //!< log2( UPDATE_PERIOD ) + 1
+
+        static constexpr double MATCH_FREQ_MIN_HZ = 100;    //!< lower edge of the band where the level is matched
+        static constexpr double MATCH_FREQ_MAX_HZ = 10000;  //!< upper edge of the band where the level is matched
+        static const int NR_OF_MATCH_FREQS = 64;            //!< number of frequencies used for level matching
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        PinkNoise
+            (
+            uint32_t    aSampleRate = NoisePwrSpectrum::DEFAULT_SAMPLE_RATE     //!< sample rate [Hz]
+            );
+
+        void filterData
+            (
+            const std::vector<double>&  aInSignal,   //!< input signal
+            std::vector<double>&        aOutSignal   //!< output signal
+            );
+
+        void reset();
+
+    private:
+        static double calculatePowerSpectrum
+            (
+            const double    aFreqNorm       //!< frequency / sample rate
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        double      mGain;                      //!< gain matching the level of the IIR filter
+        double      mRowVec[NR_OF_ROWS];        //!< values held by the rows
+};
+
+#endif // PinkNoise_h
@@ -0,0 +1,963 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+PresetFile.cpp
+This file contains the sources for reading and writing signal preset files.
+*/
+
+#include "PresetFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "MappedFile.h"
+
+
+const std::string PresetFile::DELIMITER = ", ";
+const std::string PresetFile::BINARY_EXTENSION = ".spb";
+const char PresetFile::BINARY_MAGIC[8] = { 'S', 'I', 'P', 'P', 'O', 'R', 'A', 'B' };
+
+static_assert( sizeof( double ) == 8, "the binary preset format needs 64-bit doubles" );
+
+
+//!************************************************************************
+//! Convert a value between little-endian and the host order
+//! The bytes are reversed on big-endian hosts, so the conversion is its
+//! own inverse and is used for reading as well as for writing.
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename T>
+void PresetFile::convertEndianness
+    (
+    T&                  aValue          //!< value, little-endian or in host order
+    )
+{
+    const uint16_t one = 1;
+
+    if( 0 == *reinterpret_cast<const uint8_t*>( &one ) )
+    {
+        uint8_t bytes[sizeof( T )];
+        memcpy( bytes, &aValue, sizeof( T ) );
+        std::reverse( bytes, bytes + sizeof( T ) );
+        memcpy( &aValue, bytes, sizeof( T ) );
+    }
+}
+
+
+//!************************************************************************
+//! Convert the fields of a binary header between little-endian and the
+//! host order
+//!
+//! @returns: nothing
+//!************************************************************************
+void PresetFile::convertHeader
+    (
+    BinaryHeader&       aHeader         //!< binary header
+    )
+{
+    convertEndianness( aHeader.version );
+    convertEndianness( aHeader.recordSize );
+    convertEndianness( aHeader.nrOfRecords );
+}
+
+
+//!************************************************************************
+//! Convert the fields of a binary record between little-endian and the
+//! host order
+//!
+//! @returns: nothing
+//!************************************************************************
+void PresetFile::convertRecord
+    (
+    BinaryRecord&       aRecord         //!< binary record
+    )
+{
+    convertEndianness( aRecord.intParam );
+
+    for( size_t i = 0; i < BINARY_NR_OF_PARAMS; i++ )
+    {
+        convertEndianness( aRecord.params[i] );
+    }
+}
+
+
+//!************************************************************************
+//! Create a signal item from a binary record
+//! As for a line, all the parameters must be finite, and the reserved
+//! bytes must be zero.
+//!
+//! @returns: a new signal item, or nullptr if the record is not valid
+//!************************************************************************
+SignalItem* PresetFile::fromRecord
+    (
+    const BinaryRecord& aRecord         //!< binary record
+    )
+{
+    SignalItem* crtSignal = nullptr;
+    const double* p = aRecord.params;
+
+    bool isValid = ( 0 == aRecord.reserved[0] && 0 == aRecord.reserved[1] && 0 == aRecord.reserved[2] );
+
+    for( size_t i = 0; isValid && i < BINARY_NR_OF_PARAMS; i++ )
+    {
+        isValid = std::isfinite( p[i] );
+    }
+
+    switch( isValid ? static_cast<SignalItem::SignalType>( aRecord.type ) : SignalItem::SIGNAL_TYPE_INVALID )
+    {
+        case SignalItem::SIGNAL_TYPE_TRIANGLE:
+            {
+                SignalItem::SignalTriangle sig;
+                double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tFall, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                for( size_t i = 0; i < 6; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:
+            {
+                SignalItem::SignalRectangle sig;
+                double* const valueVec[] = { &sig.tPeriod, &sig.fillFactor, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                for( size_t i = 0; i < 5; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_PULSE:
+            {
+                SignalItem::SignalPulse sig;
+                double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tWidth, &sig.tFall, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                for( size_t i = 0; i < 7; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RISEFALL:
+            {
+                SignalItem::SignalRiseFall sig;
+                double* const valueVec[] = { &sig.tDelay, &sig.tDelayRise, &sig.tRampRise, &sig.tDelayFall, &sig.tRampFall, &sig.yMax, &sig.yMin };
+
+                for( size_t i = 0; i < 7; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMP:
+            {
+                SignalItem::SignalSinDamp sig;
+                double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tDelay, &sig.amplit, &sig.offset, &sig.damping };
+
+                for( size_t i = 0; i < 6; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINRISE:
+            {
+                SignalItem::SignalSinRise sig;
+                double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tEnd, &sig.tDelay, &sig.amplit, &sig.offset, &sig.damping };
+
+                for( size_t i = 0; i < 7; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_WAVSIN:
+            {
+                SignalItem::SignalWavSin sig;
+                double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tDelay, &sig.amplit, &sig.offset };
+
+                for( size_t i = 0; i < 5; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                sig.index = static_cast<uint8_t>( aRecord.intParam );
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_AMSIN:
+            {
+                SignalItem::SignalAmSin sig;
+                double* const valueVec[] = { &sig.carrierFreqHz, &sig.carrierAmplitude, &sig.carrierOffset, &sig.carrierTDelay,
+                                             &sig.modulationFreqHz, &sig.modulationPhiRad, &sig.modulationIndex };
+
+                for( size_t i = 0; i < 7; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+            {
+                SignalItem::SignalSinDampSin sig;
+                double* const valueVec[] = { &sig.freqSinHz, &sig.tPeriodEnv, &sig.tDelay, &sig.amplit, &sig.offset };
+
+                for( size_t i = 0; i < 5; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                sig.dampingType = static_cast<int8_t>( aRecord.intParam );
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+            {
+                SignalItem::SignalTrapDampSin sig;
+                double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tWidth, &sig.tFall, &sig.tDelay,
+                                             &sig.tCross, &sig.freqHz, &sig.amplit, &sig.offset };
+
+                for( size_t i = 0; i < 9; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                crtSignal = new SignalItem( sig );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_NOISE:
+            if( aRecord.intParam >= 0 && aRecord.intParam < SignalItem::NOISE_TYPE_COUNT )
+            {
+                SignalItem::SignalNoise sig;
+                double* const valueVec[] = { &sig.gamma, &sig.tDelay, &sig.amplit, &sig.offset };
+
+                for( size_t i = 0; i < 4; i++ )
+                {
+                    *valueVec[i] = p[i];
+                }
+
+                // zero selects the default filter design, as in the first records
+                if( 0 != p[4] )
+                {
+                    sig.nrOfBlocks = ( p[4] == floor( p[4] ) && fabs( p[4] ) <= NoisePwrSpectrum::MAX_NR_OF_FILTER_BLOCKS ) ? static_cast<int>( p[4] ) : 0;
+                }
+
+                if( 0 != p[5] )
+                {
+                    sig.poleDensity = p[5];
+                }
+
+                sig.noiseType = static_cast<SignalItem::NoiseType>( aRecord.intParam );
+
+                if( isValidDesign( sig ) )
+                {
+                    crtSignal = new SignalItem( sig );
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return crtSignal;
+}
+
+
+//!************************************************************************
+//! Check the noise filter design of a Noise signal
+//!
+//! @returns: true if the number of blocks and the pole density are in range
+//!************************************************************************
+bool PresetFile::isValidDesign
+    (
+    const SignalItem::SignalNoise&  aSignalData     //!< Noise signal data
+    )
+{
+    return NoisePwrSpectrum::MIN_NR_OF_FILTER_BLOCKS <= aSignalData.nrOfBlocks
+        && aSignalData.nrOfBlocks <= NoisePwrSpectrum::MAX_NR_OF_FILTER_BLOCKS
+        && NoisePwrSpectrum::MIN_POLE_DENSITY <= aSignalData.poleDensity
+        && aSignalData.poleDensity <= NoisePwrSpectrum::MAX_POLE_DENSITY;
+}
+
+
+//!************************************************************************
+//! Parse aCount substrings of a line as doubles, starting at aFirst
+//!
+//! @returns: true if all the values could be parsed
+//!************************************************************************
+bool PresetFile::parseDoubles
+    (
+    const std::string_view  aTokenVec[],        //!< substrings of a line
+    const size_t            aFirst,             //!< index of the first parsed substring
+    double* const           aValueVec[],        //!< values
+    const size_t            aCount              //!< number of values
+    )
+{
+    bool status = true;
+
+    for( size_t i = 0; status && i < aCount; i++ )
+    {
+        status = toDouble( aTokenVec[aFirst + i], *aValueVec[i] );
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Parse a line of a preset file
+//! The line is split in place; lines with more than MAX_TOKENS substrings
+//! are rejected without being split further.
+//!
+//! @returns: a new signal item, or nullptr if the line is not valid
+//!************************************************************************
+SignalItem* PresetFile::parseLine
+    (
+    const std::string_view  aLine       //!< line of a preset file
+    )
+{
+    std::string_view substringsVec[MAX_TOKENS];
+    size_t ssCount = 0;
+    size_t start = 0;
+    size_t pos = 0;
+
+    while( ssCount <= MAX_TOKENS && ( pos = aLine.find( DELIMITER, start ) ) != std::string_view::npos )
+    {
+        if( ssCount < MAX_TOKENS )
+        {
+            substringsVec[ssCount] = aLine.substr( start, pos - start );
+        }
+
+        ssCount++;
+        start = pos + DELIMITER.length();
+    }
+
+    if( start < aLine.size() )
+    {
+        if( ssCount < MAX_TOKENS )
+        {
+            substringsVec[ssCount] = aLine.substr( start );
+        }
+
+        ssCount++;
+    }
+
+    if( ssCount > MAX_TOKENS )
+    {
+        ssCount = 0;
+    }
+
+    SignalItem* crtSignal = nullptr;
+    int crtInt = 0;
+
+    if( ssCount >= 2 && toInt( substringsVec[0], crtInt ) )
+    {
+        const size_t nrOfParams = ssCount - 1;
+
+        switch( static_cast<SignalItem::SignalType>( crtInt ) )
+        {
+            case SignalItem::SIGNAL_TYPE_TRIANGLE:
+                {
+                    SignalItem::SignalTriangle sig;
+                    double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tFall, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                    if( 6 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 6 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RECTANGLE:
+                {
+                    SignalItem::SignalRectangle sig;
+                    double* const valueVec[] = { &sig.tPeriod, &sig.fillFactor, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                    if( 5 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 5 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_PULSE:
+                {
+                    SignalItem::SignalPulse sig;
+                    double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tWidth, &sig.tFall, &sig.tDelay, &sig.yMax, &sig.yMin };
+
+                    if( 7 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 7 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RISEFALL:
+                {
+                    SignalItem::SignalRiseFall sig;
+                    double* const valueVec[] = { &sig.tDelay, &sig.tDelayRise, &sig.tRampRise, &sig.tDelayFall, &sig.tRampFall, &sig.yMax, &sig.yMin };
+
+                    if( 7 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 7 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMP:
+                {
+                    SignalItem::SignalSinDamp sig;
+                    double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tDelay, &sig.amplit, &sig.offset, &sig.damping };
+
+                    if( 6 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 6 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINRISE:
+                {
+                    SignalItem::SignalSinRise sig;
+                    double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tEnd, &sig.tDelay, &sig.amplit, &sig.offset, &sig.damping };
+
+                    if( 7 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 7 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_WAVSIN:
+                {
+                    SignalItem::SignalWavSin sig;
+                    double* const valueVec[] = { &sig.freqHz, &sig.phiRad, &sig.tDelay, &sig.amplit, &sig.offset };
+
+                    if( 6 == nrOfParams
+                     && parseDoubles( substringsVec, 1, valueVec, 5 )
+                     && toInt( substringsVec[6], crtInt )
+                      )
+                    {
+                        sig.index = crtInt;
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_AMSIN:
+                {
+                    SignalItem::SignalAmSin sig;
+                    double* const valueVec[] = { &sig.carrierFreqHz, &sig.carrierAmplitude, &sig.carrierOffset, &sig.carrierTDelay,
+                                                 &sig.modulationFreqHz, &sig.modulationPhiRad, &sig.modulationIndex };
+
+                    if( 7 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 7 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+                {
+                    SignalItem::SignalSinDampSin sig;
+                    double* const valueVec[] = { &sig.freqSinHz, &sig.tPeriodEnv, &sig.tDelay, &sig.amplit, &sig.offset };
+
+                    if( 6 == nrOfParams
+                     && parseDoubles( substringsVec, 1, valueVec, 5 )
+                     && toInt( substringsVec[6], crtInt )
+                      )
+                    {
+                        sig.dampingType = crtInt;
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+                {
+                    SignalItem::SignalTrapDampSin sig;
+                    double* const valueVec[] = { &sig.tPeriod, &sig.tRise, &sig.tWidth, &sig.tFall, &sig.tDelay,
+                                                 &sig.tCross, &sig.freqHz, &sig.amplit, &sig.offset };
+
+                    if( 9 == nrOfParams && parseDoubles( substringsVec, 1, valueVec, 9 ) )
+                    {
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            case SignalItem::SIGNAL_TYPE_NOISE:
+                {
+                    SignalItem::SignalNoise sig;
+                    double* const valueVec[] = { &sig.gamma, &sig.tDelay, &sig.amplit, &sig.offset };
+                    double* const designVec[] = { &sig.poleDensity };
+
+                    // the filter design is optional, the default one is used without it
+                    if( ( 5 == nrOfParams || 7 == nrOfParams )
+                     && toInt( substringsVec[1], crtInt )
+                     && crtInt >= 0
+                     && crtInt < SignalItem::NOISE_TYPE_COUNT
+                     && parseDoubles( substringsVec, 2, valueVec, 4 )
+                     && ( 5 == nrOfParams || ( toInt( substringsVec[6], sig.nrOfBlocks ) && parseDoubles( substringsVec, 7, designVec, 1 ) ) )
+                     && isValidDesign( sig )
+                      )
+                    {
+                        sig.noiseType = static_cast<SignalItem::NoiseType>( crtInt );
+                        crtSignal = new SignalItem( sig );
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return crtSignal;
+}
+
+
+//!************************************************************************
+//! Read the signal items from a text or binary preset file
+//!
+//! @returns: true if the file could be opened
+//!************************************************************************
+bool PresetFile::read
+    (
+    const std::string&          aFileName,              //!< file name
+    std::vector<SignalItem*>&   aSignalsVector,         //!< signals vector, valid items are appended
+    size_t*                     aNrOfInvalid            //!< number of invalid lines or records, if not null
+    )
+{
+    char magic[sizeof( BINARY_MAGIC )] = {};
+
+    std::ifstream inputFile( aFileName, std::ios::binary );
+    inputFile.read( magic, sizeof( magic ) );
+    inputFile.close();
+
+    size_t nrOfInvalid = 0;
+    const bool status = ( 0 == memcmp( magic, BINARY_MAGIC, sizeof( magic ) ) ) ? readBinary( aFileName, aSignalsVector, nrOfInvalid )
+                                                                                : readText( aFileName, aSignalsVector, nrOfInvalid );
+
+    if( aNrOfInvalid )
+    {
+        *aNrOfInvalid = nrOfInvalid;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Read the signal items from a binary preset file
+//! The file is memory mapped; invalid records are skipped.
+//!
+//! @returns: true if the file could be opened and has a supported header
+//!************************************************************************
+bool PresetFile::readBinary
+    (
+    const std::string&          aFileName,      //!< file name
+    std::vector<SignalItem*>&   aSignalsVector, //!< signals vector, valid items are appended
+    size_t&                     aNrOfInvalid    //!< number of invalid lines or records
+    )
+{
+    const MappedFile file( aFileName );
+    const char* data = file.getData();
+    const size_t fileSize = file.getSize();
+    bool status = ( file.isOpen() && fileSize >= sizeof( BinaryHeader ) );
+
+    if( status )
+    {
+        BinaryHeader header;
+        memcpy( &header, data, sizeof( header ) );
+        convertHeader( header );
+
+        status = ( 0 == memcmp( header.magic, BINARY_MAGIC, sizeof( BINARY_MAGIC ) ) )
+              && ( header.version >= 1 && header.version <= BINARY_VERSION )
+              && ( header.recordSize >= sizeof( BinaryRecord ) )
+              && ( header.nrOfRecords <= ( fileSize - sizeof( BinaryHeader ) ) / header.recordSize );
+
+        if( status )
+        {
+            const char* crtRecord = data + sizeof( BinaryHeader );
+            aSignalsVector.reserve( aSignalsVector.size() + header.nrOfRecords );
+
+            for( uint64_t i = 0; i < header.nrOfRecords; i++ )
+            {
+                BinaryRecord record;
+                memcpy( &record, crtRecord, sizeof( record ) );
+                convertRecord( record );
+                crtRecord += header.recordSize;
+
+                SignalItem* crtSignal = fromRecord( record );
+
+                if( crtSignal )
+                {
+                    aSignalsVector.push_back( crtSignal );
+                }
+                else
+                {
+                    aNrOfInvalid++;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Read the signal items from a text preset file
+//! The whole file is read at once, then parsed line by line in place.
+//! Empty lines are not counted as invalid.
+//!
+//! @returns: true if the file could be opened
+//!************************************************************************
+bool PresetFile::readText
+    (
+    const std::string&          aFileName,      //!< file name
+    std::vector<SignalItem*>&   aSignalsVector, //!< signals vector, valid items are appended
+    size_t&                     aNrOfInvalid    //!< number of invalid lines or records
+    )
+{
+    std::ifstream inputFile( aFileName, std::ios::binary | std::ios::ate );
+    bool status = inputFile.is_open();
+
+    if( status )
+    {
+        std::string content( static_cast<size_t>( inputFile.tellg() ), '\0' );
+        inputFile.seekg( 0 );
+        inputFile.read( &content[0], content.size() );
+        inputFile.close();
+
+        const std::string_view contentView( content );
+        size_t start = 0;
+
+        while( start < contentView.size() )
+        {
+            size_t end = contentView.find( '\n', start );
+
+            if( std::string_view::npos == end )
+            {
+                end = contentView.size();
+            }
+
+            const std::string_view currentLine = contentView.substr( start, end - start );
+            start = end + 1;
+
+            if( !trim( currentLine ).empty() )
+            {
+                SignalItem* crtSignal = parseLine( currentLine );
+
+                if( crtSignal )
+                {
+                    aSignalsVector.push_back( crtSignal );
+                }
+                else
+                {
+                    aNrOfInvalid++;
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Convert a string to a double, independently of the current locale
+//! Leading and trailing whitespace and a leading '+' are ignored.
+//!
+//! @returns: true if the whole string is a finite number
+//!************************************************************************
+bool PresetFile::toDouble
+    (
+    std::string_view    aString,        //!< string
+    double&             aValue          //!< value
+    )
+{
+    aString = trim( aString );
+
+    if( aString.size() > 1 && '+' == aString.front() && '-' != aString[1] )
+    {
+        aString.remove_prefix( 1 );
+    }
+
+    double value = 0;
+    const std::from_chars_result result = std::from_chars( aString.data(), aString.data() + aString.size(), value );
+    const bool status = ( !aString.empty() && std::errc() == result.ec && aString.data() + aString.size() == result.ptr && std::isfinite( value ) );
+
+    if( status )
+    {
+        aValue = value;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Convert a string to an int, independently of the current locale
+//! Leading and trailing whitespace and a leading '+' are ignored.
+//!
+//! @returns: true if the whole string is an integer
+//!************************************************************************
+bool PresetFile::toInt
+    (
+    std::string_view    aString,        //!< string
+    int&                aValue          //!< value
+    )
+{
+    aString = trim( aString );
+
+    if( aString.size() > 1 && '+' == aString.front() && '-' != aString[1] )
+    {
+        aString.remove_prefix( 1 );
+    }
+
+    int value = 0;
+    const std::from_chars_result result = std::from_chars( aString.data(), aString.data() + aString.size(), value );
+    const bool status = ( !aString.empty() && std::errc() == result.ec && aString.data() + aString.size() == result.ptr );
+
+    if( status )
+    {
+        aValue = value;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Create the binary record of a signal item
+//!
+//! @returns: the record, with type SIGNAL_TYPE_INVALID for unknown items
+//!************************************************************************
+PresetFile::BinaryRecord PresetFile::toRecord
+    (
+    const SignalItem&   aSignal         //!< signal item
+    )
+{
+    BinaryRecord record;
+    memset( &record, 0, sizeof( record ) );
+    record.type = aSignal.getType();
+
+    double* p = record.params;
+
+    switch( aSignal.getType() )
+    {
+        case SignalItem::SIGNAL_TYPE_TRIANGLE:
+            {
+                const SignalItem::SignalTriangle sig = aSignal.getSignalDataTriangle();
+                const double valueVec[] = { sig.tPeriod, sig.tRise, sig.tFall, sig.tDelay, sig.yMax, sig.yMin };
+                std::copy( valueVec, valueVec + 6, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:
+            {
+                const SignalItem::SignalRectangle sig = aSignal.getSignalDataRectangle();
+                const double valueVec[] = { sig.tPeriod, sig.fillFactor, sig.tDelay, sig.yMax, sig.yMin };
+                std::copy( valueVec, valueVec + 5, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_PULSE:
+            {
+                const SignalItem::SignalPulse sig = aSignal.getSignalDataPulse();
+                const double valueVec[] = { sig.tPeriod, sig.tRise, sig.tWidth, sig.tFall, sig.tDelay, sig.yMax, sig.yMin };
+                std::copy( valueVec, valueVec + 7, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RISEFALL:
+            {
+                const SignalItem::SignalRiseFall sig = aSignal.getSignalDataRiseFall();
+                const double valueVec[] = { sig.tDelay, sig.tDelayRise, sig.tRampRise, sig.tDelayFall, sig.tRampFall, sig.yMax, sig.yMin };
+                std::copy( valueVec, valueVec + 7, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMP:
+            {
+                const SignalItem::SignalSinDamp sig = aSignal.getSignalDataSinDamp();
+                const double valueVec[] = { sig.freqHz, sig.phiRad, sig.tDelay, sig.amplit, sig.offset, sig.damping };
+                std::copy( valueVec, valueVec + 6, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINRISE:
+            {
+                const SignalItem::SignalSinRise sig = aSignal.getSignalDataSinRise();
+                const double valueVec[] = { sig.freqHz, sig.phiRad, sig.tEnd, sig.tDelay, sig.amplit, sig.offset, sig.damping };
+                std::copy( valueVec, valueVec + 7, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_WAVSIN:
+            {
+                const SignalItem::SignalWavSin sig = aSignal.getSignalDataWavSin();
+                const double valueVec[] = { sig.freqHz, sig.phiRad, sig.tDelay, sig.amplit, sig.offset };
+                std::copy( valueVec, valueVec + 5, p );
+                record.intParam = sig.index;
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_AMSIN:
+            {
+                const SignalItem::SignalAmSin sig = aSignal.getSignalDataAmSin();
+                const double valueVec[] = { sig.carrierFreqHz, sig.carrierAmplitude, sig.carrierOffset, sig.carrierTDelay,
+                                            sig.modulationFreqHz, sig.modulationPhiRad, sig.modulationIndex };
+                std::copy( valueVec, valueVec + 7, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+            {
+                const SignalItem::SignalSinDampSin sig = aSignal.getSignalDataSinDampSin();
+                const double valueVec[] = { sig.freqSinHz, sig.tPeriodEnv, sig.tDelay, sig.amplit, sig.offset };
+                std::copy( valueVec, valueVec + 5, p );
+                record.intParam = sig.dampingType;
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+            {
+                const SignalItem::SignalTrapDampSin sig = aSignal.getSignalDataTrapDampSin();
+                const double valueVec[] = { sig.tPeriod, sig.tRise, sig.tWidth, sig.tFall, sig.tDelay,
+                                            sig.tCross, sig.freqHz, sig.amplit, sig.offset };
+                std::copy( valueVec, valueVec + 9, p );
+            }
+            break;
+
+        case SignalItem::SIGNAL_TYPE_NOISE:
+            {
+                const SignalItem::SignalNoise sig = aSignal.getSignalDataNoise();
+                const double valueVec[] = { sig.gamma, sig.tDelay, sig.amplit, sig.offset };
+                std::copy( valueVec, valueVec + 4, p );
+                record.intParam = sig.noiseType;
+
+                // the default design is left zero, so the records of existing
+                // presets, and their hashes, do not change
+                p[4] = ( NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS != sig.nrOfBlocks ) ? sig.nrOfBlocks : 0;
+                p[5] = ( NoisePwrSpectrum::DEFAULT_POLE_DENSITY != sig.poleDensity ) ? sig.poleDensity : 0;
+            }
+            break;
+
+        default:
+            record.type = SignalItem::SIGNAL_TYPE_INVALID;
+            break;
+    }
+
+    return record;
+}
+
+
+//!************************************************************************
+//! Remove leading and trailing whitespace
+//!
+//! @returns: the string without surrounding whitespace
+//!************************************************************************
+std::string_view PresetFile::trim
+    (
+    std::string_view    aString         //!< string
+    )
+{
+    const char* const WHITESPACE = " \t\r\n\v\f";
+
+    const size_t first = aString.find_first_not_of( WHITESPACE );
+    const size_t last = aString.find_last_not_of( WHITESPACE );
+
+    return ( std::string_view::npos == first ) ? std::string_view() : aString.substr( first, last - first + 1 );
+}
+
+
+//!************************************************************************
+//! Write the signal items to a binary preset file, little-endian on any host
+//!
+//! @returns: true if the file could be written
+//!************************************************************************
+bool PresetFile::writeBinary
+    (
+    const std::string&              aFileName,      //!< file name
+    const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+    )
+{
+    BinaryHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, BINARY_MAGIC, sizeof( BINARY_MAGIC ) );
+    header.version = BINARY_VERSION;
+    header.recordSize = sizeof( BinaryRecord );
+    header.nrOfRecords = aSignalsVector.size();
+    convertHeader( header );
+
+    std::vector<BinaryRecord> recordVec;
+    recordVec.reserve( aSignalsVector.size() );
+
+    for( const auto& crtSignal : aSignalsVector )
+    {
+        recordVec.push_back( toRecord( *crtSignal ) );
+        convertRecord( recordVec.back() );
+    }
+
+    std::ofstream outputFile( aFileName, std::ios::binary | std::ios::trunc );
+    bool status = outputFile.is_open();
+
+    if( status )
+    {
+        outputFile.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        outputFile.write( reinterpret_cast<const char*>( recordVec.data() ), recordVec.size() * sizeof( BinaryRecord ) );
+        outputFile.close();
+
+        status = !outputFile.fail();
+    }
+
+    return status;
+}
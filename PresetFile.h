@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+PresetFile.h
+This file contains the definitions for reading and writing signal preset files.
+*/
+
+#ifndef PresetFile_h
+#define PresetFile_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SignalItem.h"
+
+
+//************************************************************************
+// Class for reading and writing signal preset files
+//
+// A text preset file holds one signal item per line: the signal type
+// followed by its parameters, all separated by DELIMITER. Lines which
+// cannot be parsed are skipped. A Noise line may end with the number of
+// filter blocks and the pole density of its noise filter; without them
+// the default design is used. The parser does not depend on Qt, so
+// presets can be loaded without creating the GUI. The file is read at
+// once and each line is split in place, without allocations, and the
+// numbers are converted with std::from_chars.
+//
+// A binary preset file (BINARY_EXTENSION) holds a BinaryHeader followed
+// by an array of fixed-size BinaryRecord, little-endian. It is memory
+// mapped when read, and each record is copied into its item without any
+// parsing; big-endian hosts swap the bytes of every field. A record is
+// valid under the same conditions as a line: all its parameters are
+// finite, and its reserved bytes must be zero. A Noise record holds its
+// filter design after its four parameters, zero for the default one.
+// read() recognizes both formats by the magic of the header.
+//************************************************************************
+class PresetFile
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const std::string DELIMITER;         //!< parameter delimiter in a line
+        static const std::string BINARY_EXTENSION;  //!< extension of binary preset files
+        static const size_t BINARY_NR_OF_PARAMS = 9;    //!< doubles in a record, enough for any signal type
+
+        struct BinaryRecord
+        {
+            uint8_t     type;                       //!< SignalItem::SignalType
+            uint8_t     reserved[3];                //!< zero
+            int32_t     intParam;                   //!< noise type, WavSin index or SinDampSin damping type
+            double      params[BINARY_NR_OF_PARAMS];    //!< parameters, in the order of the text format
+        };
+
+    private:
+        static const size_t MAX_TOKENS = 10;        //!< substrings of a valid line, type included
+        static const char BINARY_MAGIC[8];          //!< start of a binary preset file
+        static const uint32_t BINARY_VERSION = 1;   //!< version of the binary format written
+
+        struct BinaryHeader
+        {
+            char        magic[8];                   //!< BINARY_MAGIC
+            uint32_t    version;                    //!< format version
+            uint32_t    recordSize;                 //!< size of a record [bytes], may grow in later versions
+            uint64_t    nrOfRecords;                //!< number of records following the header
+        };
+
+        static_assert( 80 == sizeof( BinaryRecord ), "unexpected size of a binary record" );
+        static_assert( 0 == offsetof( BinaryRecord, type )
+                    && 1 == offsetof( BinaryRecord, reserved )
+                    && 4 == offsetof( BinaryRecord, intParam )
+                    && 8 == offsetof( BinaryRecord, params ), "unexpected layout of a binary record" );
+
+        static_assert( 24 == sizeof( BinaryHeader ), "unexpected size of a binary header" );
+        static_assert( 0 == offsetof( BinaryHeader, magic )
+                    && 8 == offsetof( BinaryHeader, version )
+                    && 12 == offsetof( BinaryHeader, recordSize )
+                    && 16 == offsetof( BinaryHeader, nrOfRecords ), "unexpected layout of a binary header" );
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static SignalItem* parseLine
+            (
+            const std::string_view  aLine       //!< line of a preset file
+            );
+
+        static bool read
+            (
+            const std::string&          aFileName,              //!< file name
+            std::vector<SignalItem*>&   aSignalsVector,         //!< signals vector, valid items are appended
+            size_t*                     aNrOfInvalid = nullptr  //!< number of invalid lines or records, if not null
+            );
+
+        static BinaryRecord toRecord
+            (
+            const SignalItem&   aSignal         //!< signal item
+            );
+
+        static bool writeBinary
+            (
+            const std::string&              aFileName,      //!< file name
+            const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+            );
+
+    private:
+        template<typename T>
+        static void convertEndianness
+            (
+            T&                  aValue          //!< value, little-endian or in host order
+            );
+
+        static void convertHeader
+            (
+            BinaryHeader&       aHeader         //!< binary header
+            );
+
+        static void convertRecord
+            (
+            BinaryRecord&       aRecord         //!< binary record
+            );
+
+        static SignalItem* fromRecord
+            (
+            const BinaryRecord& aRecord         //!< binary record
+            );
+
+        static bool isValidDesign
+            (
+            const SignalItem::SignalNoise&  aSignalData     //!< Noise signal data
+            );
+
+        static bool readBinary
+            (
+            const std::string&          aFileName,      //!< file name
+            std::vector<SignalItem*>&   aSignalsVector, //!< signals vector, valid items are appended
+            size_t&                     aNrOfInvalid    //!< number of invalid lines or records
+            );
+
+        static bool readText
+            (
+            const std::string&          aFileName,      //!< file name
+            std::vector<SignalItem*>&   aSignalsVector, //!< signals vector, valid items are appended
+            size_t&                     aNrOfInvalid    //!< number of invalid lines or records
+            );
+
+
+        static bool parseDoubles
+            (
+            const std::string_view  aTokenVec[],        //!< substrings of a line
+            const size_t            aFirst,             //!< index of the first parsed substring
+            double* const           aValueVec[],        //!< values
+            const size_t            aCount              //!< number of values
+            );
+
+        static bool toDouble
+            (
+            std::string_view    aString,        //!< string
+            double&             aValue          //!< value
+            );
+
+        static bool toInt
+            (
+            std::string_view    aString,        //!< string
+            int&                aValue          //!< value
+            );
+
+        static std::string_view trim
+            (
+            std::string_view    aString         //!< string
+            );
+};
+
+#endif // PresetFile_h
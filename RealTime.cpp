@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RealTime.cpp
+This file contains the sources for the real-time scheduling helpers.
+*/
+
+#include "RealTime.h"
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+#endif
+
+
+//!************************************************************************
+//! Describe the obtained and the missing guarantees
+//!
+//! @returns: a text such as "priority, memory lock (missing: affinity)"
+//!************************************************************************
+std::string RealTime::describe
+    (
+    const unsigned  aGuarantees     //!< obtained guarantees, Guarantee flags
+    )
+{
+    const unsigned FLAG_VEC[] = { GUARANTEE_PRIORITY, GUARANTEE_MEMORY_LOCK, GUARANTEE_AFFINITY };
+    const char* const NAME_VEC[] = { "priority", "memory lock", "affinity" };
+
+    std::string obtained;
+    std::string missing;
+
+    for( size_t i = 0; i < sizeof( FLAG_VEC ) / sizeof( FLAG_VEC[0] ); i++ )
+    {
+        std::string& text = ( aGuarantees & FLAG_VEC[i] ) ? obtained : missing;
+        text += ( text.empty() ? "" : ", " ) + std::string( NAME_VEC[i] );
+    }
+
+    std::string description = obtained.empty() ? "none" : obtained;
+
+    if( !missing.empty() )
+    {
+        description += " (missing: " + missing + ")";
+    }
+
+    return description;
+}
+
+
+//!************************************************************************
+//! Lock memory in RAM and prefault its pages
+//! Every page is touched once, so that no page fault happens on first use.
+//!
+//! @returns: true if the memory was locked
+//!************************************************************************
+bool RealTime::lockMemory
+    (
+    void*           aData,          //!< start of the memory
+    const size_t    aSize           //!< size [bytes]
+    )
+{
+    const size_t PAGE_SIZE_MIN = 4096;
+
+    volatile char* bytes = static_cast<volatile char*>( aData );
+
+    for( size_t i = 0; i < aSize; i += PAGE_SIZE_MIN )
+    {
+        bytes[i] = bytes[i];
+    }
+
+    bool status = false;
+
+#if defined( _WIN32 )
+    status = ( 0 != VirtualLock( aData, aSize ) );
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    status = ( 0 == mlock( aData, aSize ) );
+#endif
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Pin the calling thread to one CPU
+//!
+//! @returns: true if the affinity was set
+//!************************************************************************
+bool RealTime::pinCurrentThread
+    (
+    const unsigned  aCpu            //!< CPU index
+    )
+{
+    bool status = false;
+
+#if defined( _WIN32 )
+    status = ( aCpu < 8 * sizeof( DWORD_PTR ) ) && ( 0 != SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>( 1 ) << aCpu ) );
+#elif defined( __linux__ )
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+
+    if( aCpu < CPU_SETSIZE )
+    {
+        CPU_SET( aCpu, &cpuSet );
+        status = ( 0 == pthread_setaffinity_np( pthread_self(), sizeof( cpuSet ), &cpuSet ) );
+    }
+#else
+    (void)aCpu;         // no portable affinity API
+#endif
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Give the calling thread a real-time priority
+//! SCHED_FIFO is tried first, then SCHED_RR.
+//!
+//! @returns: true if a real-time policy was set
+//!************************************************************************
+bool RealTime::promoteCurrentThread()
+{
+    bool status = false;
+
+#if defined( _WIN32 )
+    status = ( 0 != SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) );
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    const int POLICY_VEC[] = { SCHED_FIFO, SCHED_RR };
+
+    for( size_t i = 0; i < sizeof( POLICY_VEC ) / sizeof( POLICY_VEC[0] ) && !status; i++ )
+    {
+        sched_param param = {};
+        param.sched_priority = sched_get_priority_min( POLICY_VEC[i] ) + PRIORITY_ABOVE_MIN;
+
+        if( param.sched_priority > sched_get_priority_max( POLICY_VEC[i] ) )
+        {
+            param.sched_priority = sched_get_priority_max( POLICY_VEC[i] );
+        }
+
+        status = ( 0 == pthread_setschedparam( pthread_self(), POLICY_VEC[i], &param ) );
+    }
+#endif
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Unlock memory locked by lockMemory()
+//!
+//! @returns: nothing
+//!************************************************************************
+void RealTime::unlockMemory
+    (
+    void*           aData,          //!< start of the memory
+    const size_t    aSize           //!< size [bytes]
+    )
+{
+#if defined( _WIN32 )
+    VirtualUnlock( aData, aSize );
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    munlock( aData, aSize );
+#else
+    (void)aData;
+    (void)aSize;
+#endif
+}
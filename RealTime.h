@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RealTime.h
+This file contains the definitions for the real-time scheduling helpers.
+*/
+
+#ifndef RealTime_h
+#define RealTime_h
+
+#include <cstddef>
+#include <string>
+
+
+//************************************************************************
+// Class for requesting real-time guarantees from the operating system
+//
+// Every request is best effort: without the needed privileges it fails
+// and returns false, leaving the thread or memory as it was, so callers
+// can report which guarantees were actually obtained.
+//************************************************************************
+class RealTime
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        enum Guarantee
+        {
+            GUARANTEE_PRIORITY      = 1 << 0,       //!< real-time scheduling (SCHED_FIFO/SCHED_RR or time critical)
+            GUARANTEE_MEMORY_LOCK   = 1 << 1,       //!< buffers locked in RAM and prefaulted
+            GUARANTEE_AFFINITY      = 1 << 2,       //!< thread pinned to one CPU
+
+            GUARANTEE_ALL           = GUARANTEE_PRIORITY | GUARANTEE_MEMORY_LOCK | GUARANTEE_AFFINITY
+        };
+
+    private:
+        static const int PRIORITY_ABOVE_MIN = 10;   //!< real-time priority above the policy minimum
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static std::string describe
+            (
+            const unsigned  aGuarantees     //!< obtained guarantees, Guarantee flags
+            );
+
+        static bool lockMemory
+            (
+            void*           aData,          //!< start of the memory
+            const size_t    aSize           //!< size [bytes]
+            );
+
+        static bool pinCurrentThread
+            (
+            const unsigned  aCpu            //!< CPU index
+            );
+
+        static bool promoteCurrentThread();
+
+        static void unlockMemory
+            (
+            void*           aData,          //!< start of the memory
+            const size_t    aSize           //!< size [bytes]
+            );
+};
+
+#endif // RealTime_h
@@ -0,0 +1,287 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RenderCache.cpp
+This file contains the sources for the on-disk cache of rendered signals.
+*/
+
+#include "RenderCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+#include "PresetFile.h"
+
+
+const std::string RenderCache::ENTRY_EXTENSION = ".pcm";
+const std::string RenderCache::TEMP_EXTENSION = ".tmp";
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RenderCache::RenderCache
+    (
+    const std::string&  aDirectory,     //!< cache directory, created if needed
+    const uint64_t      aMaxSize        //!< maximum size of the cache [bytes]
+    )
+    : mDirectory( aDirectory )
+    , mMaxSize( aMaxSize )
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories( mDirectory, errorCode );
+
+    char suffix[32];
+    snprintf( suffix, sizeof( suffix ), ".%08x", static_cast<unsigned>( std::random_device()() ) );
+    mTempSuffix = suffix;
+}
+
+
+//!************************************************************************
+//! Make the entry written to getTempFileName() available, then remove the
+//! least recently used entries if the cache is too large
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderCache::commit
+    (
+    const std::string&  aKey            //!< key of the entry
+    )
+{
+    std::error_code errorCode;
+    std::filesystem::rename( getTempFileName( aKey ), getFileName( aKey ), errorCode );
+
+    if( errorCode )
+    {
+        discard( aKey );
+    }
+
+    evict();
+}
+
+
+//!************************************************************************
+//! Drop the entry written to getTempFileName()
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderCache::discard
+    (
+    const std::string&  aKey            //!< key of the entry
+    )
+{
+    std::error_code errorCode;
+    std::filesystem::remove( getTempFileName( aKey ), errorCode );
+}
+
+
+//!************************************************************************
+//! Remove the least recently used entries until the cache fits in its
+//! maximum size
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderCache::evict()
+{
+    struct Entry
+    {
+        std::filesystem::path               path;
+        std::filesystem::file_time_type     lastUse;
+        uint64_t                            size;
+    };
+
+    std::vector<Entry> entryVec;
+    uint64_t totalSize = 0;
+    std::error_code errorCode;
+
+    for( const auto& crtEntry : std::filesystem::directory_iterator( mDirectory, errorCode ) )
+    {
+        if( crtEntry.is_regular_file( errorCode ) && ENTRY_EXTENSION == crtEntry.path().extension() )
+        {
+            const Entry entry = { crtEntry.path(), crtEntry.last_write_time( errorCode ), crtEntry.file_size( errorCode ) };
+            entryVec.push_back( entry );
+            totalSize += entry.size;
+        }
+    }
+
+    std::sort( entryVec.begin(), entryVec.end(), []( const Entry& aLeft, const Entry& aRight ){ return aLeft.lastUse < aRight.lastUse; } );
+
+    for( size_t i = 0; i < entryVec.size() && totalSize > mMaxSize; i++ )
+    {
+        if( std::filesystem::remove( entryVec[i].path, errorCode ) )
+        {
+            totalSize -= entryVec[i].size;
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Look up an entry and mark it as used
+//! An entry which does not hold whole samples is removed.
+//!
+//! @returns: the mapped samples, or nullptr on a miss
+//!************************************************************************
+std::unique_ptr<MappedFile> RenderCache::find
+    (
+    const std::string&  aKey            //!< key of the entry
+    )
+{
+    const std::string fileName = getFileName( aKey );
+    std::unique_ptr<MappedFile> entry( new MappedFile( fileName ) );
+    std::error_code errorCode;
+
+    if( entry->isOpen() && 0 == entry->getSize() % sizeof( int16_t ) )
+    {
+        std::filesystem::last_write_time( fileName, std::filesystem::file_time_type::clock::now(), errorCode );
+    }
+    else
+    {
+        if( entry->isOpen() )
+        {
+            entry.reset();
+            std::filesystem::remove( fileName, errorCode );
+        }
+
+        entry.reset();
+    }
+
+    return entry;
+}
+
+
+//!************************************************************************
+//! Get the file name of an entry
+//!
+//! @returns: file name
+//!************************************************************************
+std::string RenderCache::getFileName
+    (
+    const std::string&  aKey            //!< key of the entry
+    ) const
+{
+    return ( std::filesystem::path( mDirectory ) / ( aKey + ENTRY_EXTENSION ) ).string();
+}
+
+
+//!************************************************************************
+//! Get the key of the entry for a rendered signal
+//!
+//! @returns: key, a hexadecimal hash
+//!************************************************************************
+std::string RenderCache::getKey
+    (
+    const uint64_t      aItemsHash,     //!< hash of the signal items, see hashItems()
+    const uint32_t      aSeed,          //!< seed of the random generators
+    const uint32_t      aSampleRate,    //!< sample rate [Hz]
+    const uint32_t      aChannelCount,  //!< number of channels
+    const uint32_t      aSampleSize     //!< sample size [bits]
+    )
+{
+    const uint64_t fieldVec[] = { FORMAT_VERSION, aItemsHash, aSeed, aSampleRate, aChannelCount, aSampleSize };
+    const uint64_t hash = hashBytes( fieldVec, sizeof( fieldVec ), 0 );
+
+    char key[17];
+    snprintf( key, sizeof( key ), "%016llx", static_cast<unsigned long long>( hash ) );
+
+    return key;
+}
+
+
+//!************************************************************************
+//! Get the seed of the random generators for rendering signal items
+//! It is derived from the items, so that the same items always give the
+//! same samples, whether played, cached or rendered to a file.
+//!
+//! @returns: seed value
+//!************************************************************************
+uint32_t RenderCache::getSeed
+    (
+    const uint64_t      aItemsHash      //!< hash of the signal items, see hashItems()
+    )
+{
+    return static_cast<uint32_t>( aItemsHash ^ ( aItemsHash >> 32 ) );
+}
+
+
+//!************************************************************************
+//! Get the name of the file where an entry is written before commit()
+//!
+//! @returns: file name
+//!************************************************************************
+std::string RenderCache::getTempFileName
+    (
+    const std::string&  aKey            //!< key of the entry
+    ) const
+{
+    return ( std::filesystem::path( mDirectory ) / ( aKey + mTempSuffix + TEMP_EXTENSION ) ).string();
+}
+
+
+//!************************************************************************
+//! Hash bytes, continuing a previous hash (FNV-1a, 64 bit)
+//! The initial hash is used when aHash is 0.
+//!
+//! @returns: hash
+//!************************************************************************
+uint64_t RenderCache::hashBytes
+    (
+    const void*         aData,          //!< data
+    const size_t        aSize,          //!< size [bytes]
+    const uint64_t      aHash           //!< hash of the previous data
+    )
+{
+    const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>( aData );
+    uint64_t hash = aHash ? aHash : FNV_OFFSET_BASIS;
+
+    for( size_t i = 0; i < aSize; i++ )
+    {
+        hash = ( hash ^ bytes[i] ) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+//!************************************************************************
+//! Hash the parameters of signal items
+//! The items are hashed through their binary preset records, which hold
+//! every parameter and no padding.
+//!
+//! @returns: hash
+//!************************************************************************
+uint64_t RenderCache::hashItems
+    (
+    const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+    )
+{
+    uint64_t hash = 0;
+
+    for( const auto& crtSignal : aSignalsVector )
+    {
+        const PresetFile::BinaryRecord record = PresetFile::toRecord( *crtSignal );
+        hash = hashBytes( &record, sizeof( record ), hash );
+    }
+
+    return hash;
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RenderCache.h
+This file contains the definitions for the on-disk cache of rendered signals.
+*/
+
+#ifndef RenderCache_h
+#define RenderCache_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "SignalItem.h"
+
+
+//************************************************************************
+// Class for caching rendered signals on disk
+//
+// Each entry holds the first 16 bit samples of a rendered signal, in a
+// file named after a key which hashes everything the samples depend on:
+// the signal items, the seed and the audio format. A sample does not
+// depend on how many samples are rendered, so an entry serves shorter
+// renders of its signal as they are, and longer ones as their beginning;
+// those then write the entry again, followed by the samples that follow.
+// Entries are written under a temporary name and renamed when complete,
+// so a reader never sees a partial entry. Hits are memory mapped. The
+// modification time of an entry is its last use, and the least recently
+// used entries are removed when the cache grows beyond its maximum size.
+//************************************************************************
+class RenderCache
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const uint64_t DEFAULT_MAX_SIZE = 1ULL << 30;   //!< default maximum size of the cache [bytes]
+
+    private:
+        static const uint32_t FORMAT_VERSION = 3;       //!< part of every key, to be increased when the rendered samples change
+        static const std::string ENTRY_EXTENSION;       //!< extension of complete entries
+        static const std::string TEMP_EXTENSION;        //!< extension of entries being written
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RenderCache
+            (
+            const std::string&  aDirectory,                     //!< cache directory, created if needed
+            const uint64_t      aMaxSize = DEFAULT_MAX_SIZE     //!< maximum size of the cache [bytes]
+            );
+
+        void commit
+            (
+            const std::string&  aKey            //!< key of the entry
+            );
+
+        void discard
+            (
+            const std::string&  aKey            //!< key of the entry
+            );
+
+        std::unique_ptr<MappedFile> find
+            (
+            const std::string&  aKey            //!< key of the entry
+            );
+
+        static std::string getKey
+            (
+            const uint64_t      aItemsHash,     //!< hash of the signal items, see hashItems()
+            const uint32_t      aSeed,          //!< seed of the random generators
+            const uint32_t      aSampleRate,    //!< sample rate [Hz]
+            const uint32_t      aChannelCount,  //!< number of channels
+            const uint32_t      aSampleSize     //!< sample size [bits]
+            );
+
+        static uint32_t getSeed
+            (
+            const uint64_t      aItemsHash      //!< hash of the signal items, see hashItems()
+            );
+
+        std::string getTempFileName
+            (
+            const std::string&  aKey            //!< key of the entry
+            ) const;
+
+        static uint64_t hashItems
+            (
+            const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+            );
+
+    private:
+        void evict();
+
+        std::string getFileName
+            (
+            const std::string&  aKey            //!< key of the entry
+            ) const;
+
+        static uint64_t hashBytes
+            (
+            const void*         aData,          //!< data
+            const size_t        aSize,          //!< size [bytes]
+            const uint64_t      aHash           //!< hash of the previous data
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::string     mDirectory;     //!< cache directory
+        uint64_t        mMaxSize;       //!< maximum size of the cache [bytes]
+        std::string     mTempSuffix;    //!< makes the temporary files of this instance unique
+};
+
+#endif // RenderCache_h
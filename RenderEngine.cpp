@@ -0,0 +1,1640 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+RenderEngine.cpp
+This file contains the sources for the signal render engine.
+*/
+
+#include "RenderEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+
+#include "RealTime.h"
+#include "WavWriter.h"
+
+
+const size_t RenderEngine::DEFAULT_CHUNK_SIZE;
+const size_t RenderEngine::CROSSFADE_LENGTH;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RenderEngine::RenderEngine
+    (
+    const uint32_t  aSampleRate,    //!< sample rate [Hz]
+    const uint32_t  aSeed           //!< seed value
+    )
+    : mSampleRate( aSampleRate ? aSampleRate : NoisePwrSpectrum::DEFAULT_SAMPLE_RATE )
+    , mSeed( aSeed )
+    , mPosition( 0 )
+    , mFadeNoise( false )
+    , mPinkNoise( mSampleRate )
+    , mMaxCount( 0 )
+{
+}
+
+
+//!************************************************************************
+//! Apply an update of the signal items prepared by prepareUpdate()
+//!
+//! If the items keep their number and types, the position and the noise
+//! generators are kept and the next rendered chunk fades from the old
+//! items to the new ones over CROSSFADE_LENGTH samples, so the change does
+//! not click. The noise of the old items is drawn from the same generator
+//! states as the new one, so only the changed parameters are faded.
+//! Otherwise the new items replace the old ones as with setData().
+//! The vectors are rotated: the replaced data is kept until it has faded
+//! out, and aUpdate receives the data faded out before, which is no longer
+//! needed. So nothing is copied or freed here. While the number of items
+//! is kept, nothing is allocated either, and the update may be applied by
+//! a real-time thread.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::applyUpdate
+    (
+    LiveUpdate&     aUpdate         //!< update prepared by prepareUpdate(), receives the data of the update before
+    )
+{
+    bool sameItems = ( aUpdate.signalsVector.size() == mSignalsVector.size() );
+    bool sameNoise = true;
+
+    for( size_t k = 0; k < aUpdate.signalsVector.size() && sameItems; k++ )
+    {
+        sameItems = ( aUpdate.signalsVector[k].getType() == mSignalsVector[k].getType() );
+
+        if( sameItems && SignalItem::SIGNAL_TYPE_NOISE == mSignalsVector[k].getType() )
+        {
+            const SignalItem::SignalNoise oldSig = mSignalsVector[k].getSignalDataNoise();
+            const SignalItem::SignalNoise newSig = aUpdate.signalsVector[k].getSignalDataNoise();
+
+            sameNoise = sameNoise
+                && oldSig.noiseType == newSig.noiseType
+                && oldSig.gamma == newSig.gamma
+                && oldSig.tDelay == newSig.tDelay
+                && oldSig.amplit == newSig.amplit
+                && oldSig.offset == newSig.offset
+                && oldSig.nrOfBlocks == newSig.nrOfBlocks
+                && oldSig.poleDensity == newSig.poleDensity;
+        }
+    }
+
+    // current -> fade -> aUpdate, aUpdate -> current
+    mFadeSignalsVector.swap( mSignalsVector );
+    mSignalsVector.swap( aUpdate.signalsVector );
+    mFadeNoiseDesignVec.swap( mNoiseDesignVec );
+    mNoiseDesignVec.swap( aUpdate.noiseDesignVec );
+    mFadeNoiseFilterVec.swap( mNoiseFilterVec );
+    mNoiseFilterVec.swap( aUpdate.noiseFilterVec );
+    mFadeNoise = sameItems && !sameNoise;
+
+    if( !sameItems )
+    {
+        mFadeSignalsVector.clear();
+        reserveBuffers();
+        reset();
+    }
+}
+
+
+//!************************************************************************
+//! Design the noise filters of a signals vector
+//! The pink noise design is filtered by PinkNoise instead.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::designNoiseFilters
+    (
+    const std::vector<SignalItem>&  aSignalsVector, //!< signals vector
+    std::vector<NoiseDesign>&       aDesignVec,     //!< distinct noise designs with a nonzero gamma, sorted
+    std::vector<NoisePwrSpectrum>&  aFilterVec      //!< filters of aDesignVec, except the pink noise one
+    ) const
+{
+    aDesignVec.clear();
+    aFilterVec.clear();
+
+    for( const auto& crtSignal : aSignalsVector )
+    {
+        if( SignalItem::SIGNAL_TYPE_NOISE == crtSignal.getType() )
+        {
+            const NoiseDesign design = getNoiseDesign( crtSignal.getSignalDataNoise() );
+
+            if( 0 != design.gamma && aDesignVec.end() == std::find( aDesignVec.begin(), aDesignVec.end(), design ) )
+            {
+                aDesignVec.push_back( design );
+            }
+        }
+    }
+
+    std::sort( aDesignVec.begin(), aDesignVec.end() );
+
+    for( const auto& crtDesign : aDesignVec )
+    {
+        if( !isPinkNoise( crtDesign ) )
+        {
+            aFilterVec.emplace_back( crtDesign.gamma, mSampleRate, crtDesign.nrOfBlocks, crtDesign.poleDensity );
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Fill a buffer with the noise of a signal item
+//! The buffer starts at the current position. The amplitude is the peak
+//! value for DEK and NAG and the RMS value for GAUSS.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::fillNoiseBuffer
+    (
+    const SignalItem::SignalNoise&  aSignalData,    //!< Noise signal data
+    NoiseState&                     aNoiseState,    //!< state of the noise generators
+    double*                         aData,          //!< noise buffer
+    const size_t                    aCount          //!< number of samples
+    ) const
+{
+    if( SignalItem::NOISE_TYPE_GAUSS == aSignalData.noiseType )
+    {
+        aNoiseState.gauss.fillGauss( aData, aCount );
+    }
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        double y = 0;
+
+        if( getTime( mPosition + i ) >= aSignalData.tDelay )
+        {
+            switch( aSignalData.noiseType )
+            {
+                case SignalItem::NOISE_TYPE_DEK:
+                    y = generateRandomDek( aNoiseState.dek );                                   // [0..1]
+                    y = 2 * y - 1;                                                              // [-1..1]
+                    break;
+
+                case SignalItem::NOISE_TYPE_NAG:
+                    y = generateRandomNag( aNoiseState.nagKey, aNoiseState.nagCounter );        // [0..1]
+                    y = 2 * y - 1;                                                              // [-1..1]
+                    break;
+
+                case SignalItem::NOISE_TYPE_GAUSS:
+                    y = aData[i];                                                               // N(0, 1)
+                    break;
+
+                default:
+                    break;
+            }
+
+            y *= aSignalData.amplit;
+            y += aSignalData.offset;
+        }
+
+        aData[i] = y;
+    }
+}
+
+
+//!************************************************************************
+//! Filter the noise of the lanes set up by renderNoise(), add it to the
+//! total noise and clear the lanes
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::filterNoiseLanes
+    (
+    std::vector<double>&    aBuffer,    //!< total noise
+    const size_t            aCount      //!< number of samples
+    )
+{
+    NoisePwrSpectrum::filterDataLanes( mLaneFilterVec, mLaneInVec, mLaneOutVec );
+
+    for( const auto& crtLaneOut : mLaneOutVec )
+    {
+        for( size_t i = 0; i < aCount; i++ )
+        {
+            aBuffer[i] += ( *crtLaneOut )[i];
+        }
+    }
+
+    mLaneFilterVec.clear();
+    mLaneInVec.clear();
+    mLaneOutVec.clear();
+}
+
+
+//!************************************************************************
+//! Generate a random number
+//! adapted from Knuth, D.E. - The Art of Computer Programming
+//!                            Volume 2, Seminumerical Algorithms
+//!                            3rd Ed, Addison-Wesley, 1997
+//!
+//! @returns: a random double in [0..1]
+//!************************************************************************
+double RenderEngine::generateRandomDek
+    (
+    DekState&       aState          //!< generator state
+    ) const
+{
+    const int32_t MBIG = 1000000000;
+    const int32_t MZ = 0;
+    const double FAC = 1.0 / MBIG;
+
+    if( ++aState.inext == DEK_TABLE_SIZE )
+    {
+        aState.inext = 1;
+    }
+
+    if( ++aState.inextp == DEK_TABLE_SIZE )
+    {
+        aState.inextp = 1;
+    }
+
+    int32_t mj = aState.ma[aState.inext] - aState.ma[aState.inextp];
+
+    if( mj < MZ )
+    {
+        mj += MBIG;
+    }
+
+    aState.ma[aState.inext] = mj;
+
+    return ( double )( mj * FAC );
+}
+
+
+//!************************************************************************
+//! Generate a random number
+//! adapted from Press, W.H. et al - Numerical Recipes in C. The Art of Scientific Computing
+//!                                  2nd Ed, Cambridge Univ. Press, 1992
+//!
+//! see ran4(), subchapter 7.5, pp. 303
+//! The counter based form makes the value depend only on (key, counter).
+//!
+//! @returns: a random double in [0..1]
+//!************************************************************************
+double RenderEngine::generateRandomNag
+    (
+    uint32_t        aKey,           //!< key
+    uint32_t&       aCounter        //!< counter, incremented
+    ) const
+{
+    const uint32_t JFLONE = 0x3f800000;
+    const uint32_t JFLMSK = 0x007fffff;
+
+    uint32_t irword = aCounter;
+    uint32_t lword = aKey;
+    pseudoDes( &lword, &irword );
+    uint32_t itemp = JFLONE | ( JFLMSK & irword );
+    ++aCounter;
+
+    float value = 0;
+    memcpy( &value, &itemp, sizeof( value ) );
+
+    return ( value - 1.0 );
+}
+
+
+//!************************************************************************
+//! Get the first sample whose time is not earlier than aTime
+//!
+//! @returns: sample index
+//!************************************************************************
+uint64_t RenderEngine::getFirstSampleAt
+    (
+    const double    aTime           //!< time
+    ) const
+{
+    uint64_t first = 0;
+    const double lastTime = std::min( std::ceil( aTime ), static_cast<double>( UINT64_MAX / mSampleRate ) );
+    uint64_t last = static_cast<uint64_t>( std::max( 0.0, lastTime ) ) * mSampleRate;
+
+    while( first < last )
+    {
+        const uint64_t middle = first + ( last - first ) / 2;
+
+        if( getTime( middle ) >= aTime )
+        {
+            last = middle;
+        }
+        else
+        {
+            first = middle + 1;
+        }
+    }
+
+    return first;
+}
+
+
+//!************************************************************************
+//! Estimate the peak memory used by renderToWav
+//!
+//! Per sample of a chunk, the render needs the output, the total noise and
+//! the current noise buffers, one buffer for each gamma and one filtered
+//! buffer per lane, plus the two 16 bit buffers of the writer thread
+//! and the stream buffer of the file.
+//!
+//! @returns: number of bytes
+//!************************************************************************
+size_t RenderEngine::getMemoryEstimate
+    (
+    const uint64_t  aNrOfSamples    //!< number of samples
+    ) const
+{
+    const size_t chunkSize = std::min<uint64_t>( DEFAULT_CHUNK_SIZE, aNrOfSamples );
+    const size_t nrOfDoubleBuffers = 3 + mNoiseDesignVec.size() + std::min( mNoiseDesignVec.size(), NoisePwrSpectrum::MAX_LANES );
+
+    return chunkSize * ( nrOfDoubleBuffers * sizeof( double ) + 2 * sizeof( int16_t ) ) + WavWriter::BUFFER_SIZE;
+}
+
+
+//!************************************************************************
+//! Get the noise filter design of a noise item
+//! A block count or a pole density out of range selects the default, as
+//! in NoisePwrSpectrum, and white noise (gamma = 0) has the default design,
+//! so that items sharing a filter share a design.
+//!
+//! @returns: noise design
+//!************************************************************************
+RenderEngine::NoiseDesign RenderEngine::getNoiseDesign
+    (
+    const SignalItem::SignalNoise&  aSignalData     //!< Noise signal data
+    )
+{
+    NoiseDesign design = { aSignalData.gamma, NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS, NoisePwrSpectrum::DEFAULT_POLE_DENSITY };
+
+    if( 0 != aSignalData.gamma
+     && NoisePwrSpectrum::MIN_NR_OF_FILTER_BLOCKS <= aSignalData.nrOfBlocks
+     && aSignalData.nrOfBlocks <= NoisePwrSpectrum::MAX_NR_OF_FILTER_BLOCKS
+      )
+    {
+        design.nrOfBlocks = aSignalData.nrOfBlocks;
+    }
+
+    if( 0 != aSignalData.gamma
+     && NoisePwrSpectrum::MIN_POLE_DENSITY <= aSignalData.poleDensity
+     && aSignalData.poleDensity <= NoisePwrSpectrum::MAX_POLE_DENSITY
+      )
+    {
+        design.poleDensity = aSignalData.poleDensity;
+    }
+
+    return design;
+}
+
+
+//!************************************************************************
+//! Get the index of the next rendered sample
+//!
+//! @returns: sample index
+//!************************************************************************
+uint64_t RenderEngine::getPosition() const
+{
+    return mPosition;
+}
+
+
+//!************************************************************************
+//! Get the sample rate
+//!
+//! @returns: sample rate [Hz]
+//!************************************************************************
+uint32_t RenderEngine::getSampleRate() const
+{
+    return mSampleRate;
+}
+
+
+//!************************************************************************
+//! Get the seed of the random generators
+//!
+//! @returns: seed value
+//!************************************************************************
+uint32_t RenderEngine::getSeed() const
+{
+    return mSeed;
+}
+
+
+//!************************************************************************
+//! Get the value of the entire signal, obtained by superposition
+//! through the entire vector *without noise*
+//!
+//! @returns The value of the signal at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValue
+    (
+    const std::vector<SignalItem>&  aSignalsVector, //!< signals vector
+    const double                    aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    for( size_t i = 0; i < aSignalsVector.size(); i++ )
+    {
+        switch( aSignalsVector.at( i ).getType() )
+        {
+            case SignalItem::SIGNAL_TYPE_TRIANGLE:
+                y += getSignalValueTriangle( aSignalsVector.at( i ).getSignalDataTriangle(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RECTANGLE:
+                y += getSignalValueRectangle( aSignalsVector.at( i ).getSignalDataRectangle(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_PULSE:
+                y += getSignalValuePulse( aSignalsVector.at( i ).getSignalDataPulse(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_RISEFALL:
+                y += getSignalValueRiseFall( aSignalsVector.at( i ).getSignalDataRiseFall(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMP:
+                y += getSignalValueSinDamp( aSignalsVector.at( i ).getSignalDataSinDamp(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINRISE:
+                y += getSignalValueSinRise( aSignalsVector.at( i ).getSignalDataSinRise(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_WAVSIN:
+                y += getSignalValueWavSin( aSignalsVector.at( i ).getSignalDataWavSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_AMSIN:
+                y += getSignalValueAmSin( aSignalsVector.at( i ).getSignalDataAmSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+                y += getSignalValueSinDampSin( aSignalsVector.at( i ).getSignalDataSinDampSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+                y += getSignalValueTrapDampSin( aSignalsVector.at( i ).getSignalDataTrapDampSin(), aTime );
+                break;
+
+            case SignalItem::SIGNAL_TYPE_NOISE: // intentionally skip noise type
+            default:
+                break;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a Triangle signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueTriangle
+    (
+    const SignalItem::SignalTriangle    aSignalData,    //!< Triangle signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tRise )
+        {
+            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
+        }
+        else
+        {
+            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise ) / aSignalData.tFall;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a Rectangle signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueRectangle
+    (
+    const SignalItem::SignalRectangle   aSignalData,    //!< Rectangle signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tPeriod * aSignalData.fillFactor )
+        {
+            y = aSignalData.yMax;
+        }
+        else
+        {
+            y = aSignalData.yMin;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a Pulse signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValuePulse
+    (
+    const SignalItem::SignalPulse       aSignalData,    //!< Pulse signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = dt0 / aSignalData.tPeriod;
+        double tInPer = dt0 - kPer * aSignalData.tPeriod;
+
+        if( tInPer <= aSignalData.tRise )
+        {
+            y = aSignalData.yMin + ( aSignalData.yMax - aSignalData.yMin ) * tInPer / aSignalData.tRise;
+        }
+        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth )
+        {
+            y = aSignalData.yMax;
+        }
+        else if( tInPer <= aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall )
+        {
+            y = aSignalData.yMax - ( aSignalData.yMax - aSignalData.yMin ) * ( tInPer - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
+        }
+        else
+        {
+            y = aSignalData.yMin;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of an exponential RiseFall signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueRiseFall
+    (
+    const SignalItem::SignalRiseFall    aSignalData,    //!< RiseFall signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        if( aTime <= aSignalData.tDelayRise )
+        {
+            y = aSignalData.yMin;
+        }
+        else if( aTime > aSignalData.tDelayRise
+              && aTime <= aSignalData.tDelayFall
+               )
+        {
+            y = aSignalData.yMin
+                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) );
+
+        }
+        else if( aTime > aSignalData.tDelayFall )
+        {
+            y = aSignalData.yMin
+                + ( aSignalData.yMax - aSignalData.yMin ) * ( 1. - exp( -( aTime - aSignalData.tDelayRise ) / aSignalData.tRampRise ) )
+                + ( aSignalData.yMin - aSignalData.yMax ) * ( 1. - exp( -( aTime - aSignalData.tDelayFall ) / aSignalData.tRampFall ) );
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinDamp signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueSinDamp
+    (
+    const SignalItem::SignalSinDamp     aSignalData,    //!< SinDamp signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+
+        y = aSignalData.offset
+            + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dt0 + aSignalData.phiRad ) * exp( -aSignalData.damping * dt0 );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinRise signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueSinRise
+    (
+    const SignalItem::SignalSinRise     aSignalData,    //!< SinRise signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        if( aTime < aSignalData.tEnd )
+        {
+            double dtend = aTime - aSignalData.tEnd;
+
+            y = aSignalData.offset
+                + aSignalData.amplit * sin( 2 * M_PI * aSignalData.freqHz * dtend + aSignalData.phiRad ) * exp( aSignalData.damping * dtend );
+        }
+        else
+        {
+            y = aSignalData.offset;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a WavSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueWavSin
+    (
+    const SignalItem::SignalWavSin      aSignalData,    //!< WavSin signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        uint8_t N = aSignalData.index;
+
+        if( N < 3
+         || N % 2 != 1
+          )
+        {
+            N = 3;
+        }
+
+        double b = aSignalData.freqHz / N;
+        double T = 0.5 / b;
+        double dt0 = aTime - aSignalData.tDelay;
+
+        if( aTime < T + aSignalData.tDelay )
+        {
+            y = aSignalData.offset
+                + aSignalData.amplit * sin( 2 * M_PI * b * dt0 ) * sin( 2 * M_PI * aSignalData.freqHz * dt0 );
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a AmSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueAmSin
+    (
+    const SignalItem::SignalAmSin       aSignalData,    //!< AmSin signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.carrierTDelay )
+    {
+        double dt0 = aTime - aSignalData.carrierTDelay;
+
+        y = aSignalData.carrierOffset
+            + aSignalData.carrierAmplitude * sin( 2 * M_PI * aSignalData.carrierFreqHz * dt0 )
+            * ( 1 + aSignalData.modulationIndex * cos( 2 * M_PI * aSignalData.modulationFreqHz * dt0 + aSignalData.modulationPhiRad ) );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a SinDampSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueSinDampSin
+    (
+    const SignalItem::SignalSinDampSin  aSignalData,    //!< SinDampSin signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double eyeAmplit = aSignalData.amplit;
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = 1 + dt0 / aSignalData.tPeriodEnv;
+
+        switch( aSignalData.dampingType )
+        {
+            case 0:
+                break;
+
+            case -3:
+                eyeAmplit *= exp( kPer - 1.0 );
+                break;
+
+            case -2:
+            case -1:
+            case 1:
+            case 2:
+                eyeAmplit *= pow( static_cast<double>( kPer ), -aSignalData.dampingType );
+                break;
+
+            case 3:
+                eyeAmplit *= exp( -( kPer - 1.0 ) );
+                break;
+
+            default:
+                eyeAmplit = 0;
+                break;
+        }
+
+        y = aSignalData.offset
+                + eyeAmplit * sin( M_PI / aSignalData.tPeriodEnv * dt0 ) * sin( 2 * M_PI * aSignalData.freqSinHz * dt0 );
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the value of a TrapDampSin signal
+//!
+//! @returns The signal value at a specified moment
+//!************************************************************************
+double RenderEngine::getSignalValueTrapDampSin
+    (
+    const SignalItem::SignalTrapDampSin aSignalData,    //!< TrapDampSin signal data
+    const double                        aTime           //!< time
+    ) const
+{
+    double y = 0;
+
+    if( aTime >= aSignalData.tDelay )
+    {
+        double dt0 = aTime - aSignalData.tDelay;
+        uint32_t kPer = 1 + dt0 / aSignalData.tPeriod;
+
+        if( aTime >= aSignalData.tCross
+       || ( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
+         && aTime < aSignalData.tDelay + kPer * aSignalData.tPeriod )
+          )
+        {
+            y = aSignalData.offset;
+        }
+        else
+        {
+            double yEnv = 0;
+
+            if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod
+            &&  aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
+              )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
+                yEnv /= aSignalData.tCross;
+
+                y = ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) / aSignalData.tRise;
+                y *= yEnv;
+            }
+            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise
+                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
+                   )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise );
+                yEnv /= aSignalData.tCross;
+
+                y = yEnv - aSignalData.amplit * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise ) / aSignalData.tCross;
+            }
+            else if( aTime > aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth
+                  && aTime <= aSignalData.tDelay + ( kPer - 1 ) * aSignalData.tPeriod + aSignalData.tRise + aSignalData.tWidth + aSignalData.tFall
+                  )
+            {
+                yEnv = aSignalData.amplit * ( aSignalData.tCross - aSignalData.tDelay - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth );
+                yEnv /= aSignalData.tCross;
+
+                y = 1 - ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod - aSignalData.tRise - aSignalData.tWidth ) / aSignalData.tFall;
+                y *= yEnv;
+            }
+
+            y *= sin( 2 * M_PI * aSignalData.freqHz * ( dt0 - ( kPer - 1 ) * aSignalData.tPeriod ) );
+            y += aSignalData.offset;
+        }
+    }
+
+    return y;
+}
+
+
+//!************************************************************************
+//! Get the time and bytes of each stage of the renders since the last
+//! resetStats() or renderToWav()
+//!
+//! @returns: the statistics
+//!************************************************************************
+const RenderStats& RenderEngine::getStats() const
+{
+    return mStats;
+}
+
+
+//!************************************************************************
+//! Get the time of a sample
+//!
+//! @returns: time [s]
+//!************************************************************************
+double RenderEngine::getTime
+    (
+    const uint64_t  aSampleIndex    //!< sample index
+    ) const
+{
+    double time = static_cast<double>( aSampleIndex % mSampleRate ) / mSampleRate;
+    time += static_cast<double>( aSampleIndex / mSampleRate );
+
+    return time;
+}
+
+
+//!************************************************************************
+//! Initialize the table of the DEK generator
+//! adapted from Knuth, D.E. - The Art of Computer Programming
+//!                            Volume 2, Seminumerical Algorithms
+//!                            3rd Ed, Addison-Wesley, 1997
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::initRandomDek
+    (
+    DekState&       aState,         //!< generator state
+    const int32_t   aSeed           //!< seed value
+    )
+{
+    const int32_t MBIG = 1000000000;
+    const int32_t MSEED = 161803398;
+    const int32_t MZ = 0;
+
+    int32_t mj = labs( MSEED - labs( aSeed ) );
+    mj %= MBIG;
+    aState.ma[55] = mj;
+    int32_t mk = 1;
+
+    for( int32_t i = 1; i <= 54; i++ )
+    {
+        int32_t ii = ( 21 * i ) % 55;
+        aState.ma[ii] = mk;
+        mk = mj - mk;
+
+        if( mk < MZ )
+        {
+            mk += MBIG;
+        }
+
+        mj = aState.ma[ii];
+    }
+
+    for( int32_t k = 1; k <= 4; k++ )
+    {
+        for( int32_t i = 1; i <= 55; i++ )
+        {
+            aState.ma[i] -= aState.ma[ 1 + ( i + 30 ) % 55 ];
+
+            if( aState.ma[i] < MZ )
+            {
+                aState.ma[i] += MBIG;
+            }
+        }
+    }
+
+    aState.inext = 0;
+    aState.inextp = 31;
+}
+
+
+//!************************************************************************
+//! Check if a noise design is rendered by the pink noise engine
+//! Only the default design is; other designs of the pink noise gamma are
+//! filtered by NoisePwrSpectrum as requested.
+//!
+//! @returns: true for PinkNoise::GAMMA with the default design
+//!************************************************************************
+bool RenderEngine::isPinkNoise
+    (
+    const NoiseDesign&  aDesign     //!< noise design
+    )
+{
+    return PinkNoise::GAMMA == aDesign.gamma
+        && NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS == aDesign.nrOfBlocks
+        && NoisePwrSpectrum::DEFAULT_POLE_DENSITY == aDesign.poleDensity;
+}
+
+
+//!************************************************************************
+//! Lock a buffer in RAM, see RealTime::lockMemory()
+//! Empty buffers need no locking.
+//!
+//! @returns: true if the buffer was locked
+//!************************************************************************
+template<typename T>
+bool RenderEngine::lockBuffer
+    (
+    std::vector<T>& aBuffer         //!< buffer
+    )
+{
+    return aBuffer.empty() || RealTime::lockMemory( aBuffer.data(), aBuffer.capacity() * sizeof( T ) );
+}
+
+
+//!************************************************************************
+//! Lock in RAM the scratch buffers and the noise generators used by
+//! render(), for real-time rendering
+//! The buffers must have been sized by reserve() and setData() first;
+//! they keep their storage until the next setData().
+//!
+//! @returns: true if all of them were locked
+//!************************************************************************
+bool RenderEngine::lockMemory()
+{
+    bool status = lockBuffer( mTotalNoiseBuffer )
+               && lockBuffer( mCrtNoiseBuffer )
+               && lockBuffer( mFadeNoiseBuffer )
+               && lockBuffer( mNoiseStateVec );
+
+    for( auto& crtBuffer : mDesignNoiseVec )
+    {
+        status = status && lockBuffer( crtBuffer );
+    }
+
+    for( auto& crtBuffer : mFilteredNoiseVec )
+    {
+        status = status && lockBuffer( crtBuffer );
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Pseudo DES (Data Encryption Standard)
+//! adapted from Press, W.H. et al - Numerical Recipes in C. The Art of Scientific Computing
+//!                                  2nd Ed, Cambridge Univ. Press, 1992
+//! see psdes(), subchapter 7.5, page 302
+//!
+//! This function is used by generateRandomNag()
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::pseudoDes
+    (
+    uint32_t*   lword,      //!< left word
+    uint32_t*   irword      //!< right word
+    ) const
+{
+    const uint8_t NITER = 4;
+    const uint32_t C1[NITER] = { 0xbaa96887, 0x1e17d32c, 0x03bcdc3c, 0x0f33d1b2 };
+    const uint32_t C2[NITER] = { 0x4b0f3b58, 0xe874f0c3, 0x6955c5a6, 0x55a7ca46 };
+    uint32_t iswap = 0;
+
+    for( uint8_t i = 0; i < NITER; i++ )
+    {
+        uint32_t ia = ( iswap = ( *irword ) ) ^ C1[i];
+        uint32_t itmpl = ia & 0xffff;
+        uint32_t itmph = ia >> 16;
+        uint32_t ib = itmpl * itmpl + ~( itmph * itmph );
+        *irword = ( *lword ) ^ ( ( ( ia = ( ib >> 16 ) | ( ( ib & 0xffff ) << 16 ) ) ^ C2[i] ) + itmpl * itmph );
+        *lword = iswap;
+    }
+}
+
+
+//!************************************************************************
+//! Convert rendered samples to 16 bit samples
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::quantize
+    (
+    const double*   aData,          //!< rendered samples
+    int16_t*        aSamples,       //!< 16 bit samples
+    const size_t    aCount          //!< number of samples
+    )
+{
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        aSamples[i] = static_cast<int16_t>( aData[i] * 32767 );
+    }
+}
+
+
+//!************************************************************************
+//! Render the next samples of the signal, starting at the current position
+//!
+//! The noise filters clear their state every CHUNK_ALIGNMENT samples,
+//! so the output of consecutive chunks matches a single render as long
+//! as every chunk but the last one has a length multiple of CHUNK_ALIGNMENT.
+//! Chunks not longer than the length given to reserve() neither allocate
+//! nor take a lock; longer ones grow the scratch buffers once.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::render
+    (
+    double*         aData,          //!< output samples
+    const size_t    aCount          //!< number of samples
+    )
+{
+    // after updateData(), fade from the previous parameters to the new ones
+    const size_t fadeLength = mFadeSignalsVector.empty() ? 0 : std::min( aCount, CROSSFADE_LENGTH );
+
+    if( mFadeNoise && fadeLength )
+    {
+        // the replaced noise items, drawn from the same generator states
+        const PinkNoise pinkNoise = mPinkNoise;
+        mSavedNoiseStateVec = mNoiseStateVec;
+
+        renderNoise( mFadeSignalsVector, mFadeNoiseDesignVec, mFadeNoiseFilterVec, mFadeNoiseBuffer, fadeLength );
+
+        mNoiseStateVec = mSavedNoiseStateVec;
+        mPinkNoise = pinkNoise;
+    }
+
+    renderNoise( mSignalsVector, mNoiseDesignVec, mNoiseFilterVec, mTotalNoiseBuffer, aCount );
+
+    const RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        aData[i] = getSignalValue( mSignalsVector, getTime( mPosition + i ) ) + mTotalNoiseBuffer[i];
+    }
+
+    for( size_t i = 0; i < fadeLength; i++ )
+    {
+        const double weight = static_cast<double>( i + 1 ) / ( fadeLength + 1 );
+        const double time = getTime( mPosition + i );
+        const double noiseStep = mFadeNoise ? mFadeNoiseBuffer[i] - mTotalNoiseBuffer[i] : 0;
+
+        aData[i] += ( 1 - weight ) * ( getSignalValue( mFadeSignalsVector, time ) - getSignalValue( mSignalsVector, time ) + noiseStep );
+    }
+
+    if( fadeLength )
+    {
+        mFadeSignalsVector.clear();
+        mFadeNoise = false;
+    }
+
+    mStats.add( RenderStats::STAGE_SYNTHESIS, RenderStats::getNanosecondsSince( t0 ), aCount * sizeof( double ) );
+    mPosition += aCount;
+}
+
+
+//!************************************************************************
+//! Prepare an update of the signal items, for applyUpdate()
+//!
+//! The items are copied and their noise filters are designed here, which
+//! may allocate and take the lock of NoisePwrSpectrum::getFilter(). Only
+//! the sample rate of the engine is read, so this may run on another
+//! thread than the one rendering.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::prepareUpdate
+    (
+    const std::vector<SignalItem>&  aSignalsVector, //!< new signals vector
+    LiveUpdate&                     aUpdate         //!< prepared update
+    ) const
+{
+    aUpdate.signalsVector = aSignalsVector;
+    designNoiseFilters( aSignalsVector, aUpdate.noiseDesignVec, aUpdate.noiseFilterVec );
+}
+
+
+//!************************************************************************
+//! Render the noise of signal items, starting at the current position
+//! The generators of the items advance, the position does not.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::renderNoise
+    (
+    const std::vector<SignalItem>&          aSignalsVector, //!< signals vector
+    const std::vector<NoiseDesign>&         aDesignVec,     //!< distinct noise designs of aSignalsVector with a nonzero gamma
+    const std::vector<NoisePwrSpectrum>&    aFilterVec,     //!< filters of aDesignVec, except the pink noise one
+    std::vector<double>&                    aBuffer,        //!< sum of the noise of all the items
+    const size_t                            aCount          //!< number of samples
+    )
+{
+    RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+
+    // The noise filter is linear, so all the white noise items sharing
+    // the same design are summed first and then filtered only once.
+    const NoiseDesign whiteDesign = { 0, NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS, NoisePwrSpectrum::DEFAULT_POLE_DENSITY };
+    uint64_t nrOfNoiseStreams = sumNoise( aSignalsVector, whiteDesign, aBuffer, aCount );
+
+    for( size_t g = 0; g < aDesignVec.size(); g++ )
+    {
+        nrOfNoiseStreams += sumNoise( aSignalsVector, aDesignVec[g], mDesignNoiseVec[g], aCount );
+    }
+
+    mStats.add( RenderStats::STAGE_NOISE_GENERATION, RenderStats::getNanosecondsSince( t0 ), nrOfNoiseStreams * aCount * sizeof( double ) );
+    t0 = RenderStats::Clock::now();
+
+    for( size_t g = 0; g < aDesignVec.size(); g++ )
+    {
+        if( isPinkNoise( aDesignVec[g] ) )
+        {
+            mFilteredNoiseVec[0].resize( aCount );
+
+            mPinkNoise.filterData( mDesignNoiseVec[g], mFilteredNoiseVec[0] );
+
+            for( size_t i = 0; i < aCount; i++ )
+            {
+                aBuffer[i] += mFilteredNoiseVec[0][i];
+            }
+        }
+    }
+
+    // The IIR filters are run NoisePwrSpectrum::MAX_LANES at a time,
+    // each design in its own lane.
+    size_t crtFilter = 0;
+
+    for( size_t g = 0; g < aDesignVec.size(); g++ ) // any gamma in [-2..2] except 0
+    {
+        if( !isPinkNoise( aDesignVec[g] ) )
+        {
+            const size_t crtLane = mLaneFilterVec.size();
+            mFilteredNoiseVec[crtLane].resize( aCount );
+
+            mLaneFilterVec.push_back( &aFilterVec[crtFilter++] );
+            mLaneInVec.push_back( &mDesignNoiseVec[g] );
+            mLaneOutVec.push_back( &mFilteredNoiseVec[crtLane] );
+
+            if( NoisePwrSpectrum::MAX_LANES == mLaneFilterVec.size() )
+            {
+                filterNoiseLanes( aBuffer, aCount );
+            }
+        }
+    }
+
+    if( !mLaneFilterVec.empty() )
+    {
+        filterNoiseLanes( aBuffer, aCount );
+    }
+
+    mStats.add( RenderStats::STAGE_NOISE_FILTERING, RenderStats::getNanosecondsSince( t0 ), aDesignVec.size() * aCount * sizeof( double ) );
+}
+
+
+//!************************************************************************
+//! Render the signal to a WAV file, from its start or from aFirstSample
+//!
+//! The signal is rendered in chunks of DEFAULT_CHUNK_SIZE samples. Each
+//! chunk is written by a separate thread while the next one is rendered,
+//! so only two chunks are held in memory whatever the length of the file.
+//! Files rendered for consecutive ranges can be concatenated into the
+//! same samples as a single render (see seek()).
+//! The statistics are cleared first, so that they describe this file.
+//!
+//! @returns: true if the file was written successfully
+//!************************************************************************
+bool RenderEngine::renderToWav
+    (
+    const std::string&  aFileName,          //!< output file name
+    const uint64_t      aNrOfSamples,       //!< number of samples
+    const uint64_t      aFirstSample        //!< index of the first sample, multiple of CHUNK_ALIGNMENT
+    )
+{
+    WavWriter wavWriter;
+    bool status = wavWriter.open( aFileName, mSampleRate, 1 );
+
+    mStats.reset();
+
+    if( status )
+    {
+        seek( aFirstSample );
+
+        std::vector<double> data( std::min<uint64_t>( DEFAULT_CHUNK_SIZE, aNrOfSamples ) );
+        std::vector<int16_t> samples[2] = { std::vector<int16_t>( data.size() ), std::vector<int16_t>( data.size() ) };
+        std::thread writeThread;
+        bool writeStatus = true;
+        uint64_t writeNs = 0;
+        int crtBuffer = 0;
+
+        for( uint64_t rendered = 0; rendered < aNrOfSamples; )
+        {
+            const size_t count = std::min<uint64_t>( data.size(), aNrOfSamples - rendered );
+
+            render( data.data(), count );
+
+            const RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+            quantize( data.data(), samples[crtBuffer].data(), count );
+            mStats.add( RenderStats::STAGE_QUANTIZATION, RenderStats::getNanosecondsSince( t0 ), count * sizeof( int16_t ) );
+
+            if( writeThread.joinable() )
+            {
+                writeThread.join();
+            }
+
+            writeThread = std::thread( [&wavWriter, &writeStatus, &writeNs, &samples, crtBuffer, count]()
+                                       {
+                                           const RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+                                           writeStatus = wavWriter.write( samples[crtBuffer].data(), count ) && writeStatus;
+                                           writeNs += RenderStats::getNanosecondsSince( t0 );
+                                       } );
+
+            crtBuffer = 1 - crtBuffer;
+            rendered += count;
+        }
+
+        if( writeThread.joinable() )
+        {
+            writeThread.join();
+        }
+
+        // the writes overlap the rendering of the next chunk
+        mStats.add( RenderStats::STAGE_COPY, writeNs, aNrOfSamples * sizeof( int16_t ) );
+
+        status = wavWriter.close() && writeStatus;
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Reserve the scratch buffers of render() for chunks of up to aMaxCount
+//! samples, so that rendering them does not allocate
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::reserve
+    (
+    const size_t    aMaxCount       //!< maximum number of samples rendered at once
+    )
+{
+    mMaxCount = aMaxCount;
+    reserveBuffers();
+}
+
+
+//!************************************************************************
+//! Size the scratch buffers for the current signal items
+//!
+//! There is one summed noise buffer per signal item, since an update
+//! may turn each of them into noise with its own gamma, and one filtered
+//! buffer per lane. Buffers are only added, and each one holds at least
+//! the reserved length, so they keep their storage while the number of
+//! items is kept.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::reserveBuffers()
+{
+    const size_t nrOfItems = mSignalsVector.size();
+
+    if( mDesignNoiseVec.size() < nrOfItems )
+    {
+        mDesignNoiseVec.resize( nrOfItems );
+    }
+
+    if( mFilteredNoiseVec.size() < std::min( nrOfItems, NoisePwrSpectrum::MAX_LANES ) )
+    {
+        mFilteredNoiseVec.resize( std::min( nrOfItems, NoisePwrSpectrum::MAX_LANES ) );
+    }
+
+    mTotalNoiseBuffer.resize( std::max( mTotalNoiseBuffer.size(), mMaxCount ) );
+    mCrtNoiseBuffer.resize( std::max( mCrtNoiseBuffer.size(), mMaxCount ) );
+    mFadeNoiseBuffer.resize( std::max( mFadeNoiseBuffer.size(), mMaxCount ) );
+    mSavedNoiseStateVec.reserve( nrOfItems );
+
+    for( auto& crtBuffer : mDesignNoiseVec )
+    {
+        crtBuffer.resize( std::max( crtBuffer.size(), mMaxCount ) );
+    }
+
+    for( auto& crtBuffer : mFilteredNoiseVec )
+    {
+        crtBuffer.resize( std::max( crtBuffer.size(), mMaxCount ) );
+    }
+
+    mLaneFilterVec.reserve( NoisePwrSpectrum::MAX_LANES );
+    mLaneInVec.reserve( NoisePwrSpectrum::MAX_LANES );
+    mLaneOutVec.reserve( NoisePwrSpectrum::MAX_LANES );
+}
+
+
+//!************************************************************************
+//! Rewind to the start of the signal and reseed the random generators
+//! Signal item k uses the seed (seed + k).
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::reset()
+{
+    mPosition = 0;
+    mNoiseStateVec.clear();
+
+    for( size_t k = 0; k < mSignalsVector.size(); k++ )
+    {
+        const uint32_t itemSeed = mSeed + static_cast<uint32_t>( k );
+
+        mNoiseStateVec.emplace_back( itemSeed );
+        initRandomDek( mNoiseStateVec.back().dek, static_cast<int32_t>( itemSeed & 0x7fffffff ) );
+    }
+
+    mPinkNoise.reset();
+}
+
+
+//!************************************************************************
+//! Clear the statistics of the render stages
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::resetStats()
+{
+    mStats.reset();
+}
+
+
+//!************************************************************************
+//! Move to a sample index, as if all the previous samples were rendered
+//!
+//! The position is rounded down to a multiple of CHUNK_ALIGNMENT. The
+//! Gauss and NAG generators are counter based and jump directly, the
+//! DEK generator is stepped once per skipped sample after its delay.
+//! The IIR filters restart at every CHUNK_ALIGNMENT boundary, but the
+//! pink noise rows carry over, so the last period before the position
+//! is rendered again and discarded to warm them up.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::seek
+    (
+    const uint64_t  aPosition       //!< sample index
+    )
+{
+    const uint64_t position = aPosition - aPosition % CHUNK_ALIGNMENT;
+    const uint64_t warmUpPosition = ( position >= CHUNK_ALIGNMENT ) ? position - CHUNK_ALIGNMENT : 0;
+
+    // there is nothing to fade from at another position
+    mFadeSignalsVector.clear();
+    mFadeNoise = false;
+    reset();
+
+    for( size_t k = 0; k < mSignalsVector.size(); k++ )
+    {
+        if( SignalItem::SIGNAL_TYPE_NOISE == mSignalsVector.at( k ).getType() )
+        {
+            const SignalItem::SignalNoise sig = mSignalsVector.at( k ).getSignalDataNoise();
+            NoiseState& noiseState = mNoiseStateVec.at( k );
+
+            const uint64_t nrOfDrawnSamples = warmUpPosition - std::min( warmUpPosition, getFirstSampleAt( sig.tDelay ) );
+
+            noiseState.gauss.setPosition( warmUpPosition );
+
+            if( SignalItem::NOISE_TYPE_DEK == sig.noiseType )
+            {
+                for( uint64_t i = 0; i < nrOfDrawnSamples; i++ )
+                {
+                    generateRandomDek( noiseState.dek );
+                }
+            }
+            else if( SignalItem::NOISE_TYPE_NAG == sig.noiseType )
+            {
+                noiseState.nagCounter += static_cast<uint32_t>( nrOfDrawnSamples );
+            }
+        }
+    }
+
+    mPosition = warmUpPosition;
+
+    if( position > warmUpPosition )
+    {
+        double warmUpData[CHUNK_ALIGNMENT];
+        render( warmUpData, static_cast<size_t>( position - warmUpPosition ) );
+    }
+}
+
+
+//!************************************************************************
+//! Set the data for entire waveform
+//! The items are copied, so the caller may modify or delete its own.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::setData
+    (
+    const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+    )
+{
+    mSignalsVector.clear();
+
+    for( const auto& crtSignal : aSignalsVector )
+    {
+        mSignalsVector.push_back( *crtSignal );
+    }
+
+    mFadeSignalsVector.clear();
+    mFadeNoise = false;
+    designNoiseFilters( mSignalsVector, mNoiseDesignVec, mNoiseFilterVec );
+    reserveBuffers();
+    reset();
+}
+
+
+//!************************************************************************
+//! Set the seed of the random generators and rewind
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::setSeed
+    (
+    const uint32_t  aSeed           //!< seed value
+    )
+{
+    mSeed = aSeed;
+    reset();
+}
+
+
+//!************************************************************************
+//! Sum the noise of the signal items having a noise design
+//! The first item is generated directly into the sum, the others are
+//! added in the order of the items.
+//!
+//! @returns: number of summed items
+//!************************************************************************
+size_t RenderEngine::sumNoise
+    (
+    const std::vector<SignalItem>&  aSignalsVector, //!< signal items
+    const NoiseDesign&              aDesign,        //!< noise design
+    std::vector<double>&            aBuffer,        //!< sum of the noise items having aDesign
+    const size_t                    aCount          //!< number of samples
+    )
+{
+    size_t nrOfItems = 0;
+
+    aBuffer.resize( aCount );
+
+    for( size_t k = 0; k < aSignalsVector.size(); k++ )
+    {
+        if( SignalItem::SIGNAL_TYPE_NOISE == aSignalsVector.at( k ).getType() )
+        {
+            SignalItem::SignalNoise sig = aSignalsVector.at( k ).getSignalDataNoise();
+
+            if( aDesign == getNoiseDesign( sig ) )
+            {
+                if( 0 == nrOfItems )
+                {
+                    fillNoiseBuffer( sig, mNoiseStateVec.at( k ), aBuffer.data(), aCount );
+                }
+                else
+                {
+                    mCrtNoiseBuffer.resize( aCount );
+                    fillNoiseBuffer( sig, mNoiseStateVec.at( k ), mCrtNoiseBuffer.data(), aCount );
+
+                    for( size_t i = 0; i < aCount; i++ )
+                    {
+                        aBuffer[i] += mCrtNoiseBuffer[i];
+                    }
+                }
+
+                nrOfItems++;
+            }
+        }
+    }
+
+    if( 0 == nrOfItems )
+    {
+        std::fill( aBuffer.begin(), aBuffer.end(), 0 );
+    }
+
+    return nrOfItems;
+}
+
+
+//!************************************************************************
+//! Unlock a buffer locked by lockBuffer()
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename T>
+void RenderEngine::unlockBuffer
+    (
+    std::vector<T>& aBuffer         //!< buffer
+    )
+{
+    if( !aBuffer.empty() )
+    {
+        RealTime::unlockMemory( aBuffer.data(), aBuffer.capacity() * sizeof( T ) );
+    }
+}
+
+
+//!************************************************************************
+//! Unlock the memory locked by lockMemory()
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::unlockMemory()
+{
+    unlockBuffer( mTotalNoiseBuffer );
+    unlockBuffer( mCrtNoiseBuffer );
+    unlockBuffer( mFadeNoiseBuffer );
+    unlockBuffer( mNoiseStateVec );
+    unlockBuffer( mSavedNoiseStateVec );
+
+    for( auto& crtBuffer : mDesignNoiseVec )
+    {
+        unlockBuffer( crtBuffer );
+    }
+
+    for( auto& crtBuffer : mFilteredNoiseVec )
+    {
+        unlockBuffer( crtBuffer );
+    }
+}
+
+
+//!************************************************************************
+//! Update the parameters of the signal items while rendering
+//! Same as prepareUpdate() followed by applyUpdate().
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderEngine::updateData
+    (
+    const std::vector<SignalItem>&  aSignalsVector  //!< new signals vector
+    )
+{
+    LiveUpdate update;
+
+    prepareUpdate( aSignalsVector, update );
+    applyUpdate( update );
+}
@@ -0,0 +1,408 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+RenderEngine.h
+This file contains the definitions for the signal render engine.
+*/
+
+#ifndef RenderEngine_h
+#define RenderEngine_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "NoiseGenerator.h"
+#include "NoisePwrSpectrum.h"
+#include "PinkNoise.h"
+#include "RenderStats.h"
+#include "SignalItem.h"
+
+
+//************************************************************************
+// Class for rendering the superposition of the signal items
+//
+// The engine does not depend on Qt. It renders consecutive chunks of
+// samples starting at getPosition(), so that arbitrarily long signals
+// can be produced without holding the whole waveform in memory.
+// All random generators are owned by the engine, one per signal item,
+// and derived from an explicit seed, so a render is reproducible.
+// The time spent in each stage of render() is accumulated in getStats().
+// Noise items sharing a gamma and a filter design (number of blocks and
+// pole density) are summed and filtered once.
+// After updateData() the next chunk crossfades from the old items to the
+// new ones, the filtered noise included.
+// The noise filters are designed by setData() and prepareUpdate(), and
+// the scratch buffers are kept between chunks, so after reserve() a chunk
+// of up to the reserved length is rendered without allocating or locking.
+//************************************************************************
+class RenderEngine
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const size_t CHUNK_ALIGNMENT = NoisePwrSpectrum::FILTER_RESET_PERIOD;  //!< chunks must have a length multiple of this, except the last one
+        static const size_t DEFAULT_CHUNK_SIZE = 1 << 20;                               //!< number of samples rendered at once for long signals
+        static const size_t CROSSFADE_LENGTH = 4 * CHUNK_ALIGNMENT;                     //!< length of the fade after updateData() [samples]
+
+        struct NoiseDesign
+        {
+            double      gamma;              //!< frequency exponent
+            int         nrOfBlocks;         //!< number of filter blocks
+            double      poleDensity;        //!< number of poles / decade
+
+            bool operator==
+                (
+                const NoiseDesign& aDesign  //!< other design
+                ) const
+            {
+                return std::tie( gamma, nrOfBlocks, poleDensity )
+                    == std::tie( aDesign.gamma, aDesign.nrOfBlocks, aDesign.poleDensity );
+            }
+
+            bool operator<
+                (
+                const NoiseDesign& aDesign  //!< other design
+                ) const
+            {
+                return std::tie( gamma, nrOfBlocks, poleDensity )
+                     < std::tie( aDesign.gamma, aDesign.nrOfBlocks, aDesign.poleDensity );
+            }
+        };
+
+        struct LiveUpdate
+        {
+            std::vector<SignalItem>         signalsVector;  //!< new signals vector, then the data faded out before
+            std::vector<NoiseDesign>        noiseDesignVec; //!< distinct noise designs with a nonzero gamma, sorted, then the data faded out before
+            std::vector<NoisePwrSpectrum>   noiseFilterVec; //!< filters of noiseDesignVec, except the pink noise one, then the data faded out before
+        };
+
+    private:
+        static const int DEK_TABLE_SIZE = 56;       //!< size of the subtractive generator table
+
+        struct DekState
+        {
+            int32_t     inext;                      //!< index of the next table entry
+            int32_t     inextp;                     //!< index of the lagged table entry
+            int32_t     ma[DEK_TABLE_SIZE];         //!< table
+        };
+
+        struct NoiseState
+        {
+            NoiseGenerator      gauss;              //!< Gaussian generator
+            DekState            dek;                //!< DEK generator
+            uint32_t            nagKey;             //!< NAG generator key
+            uint32_t            nagCounter;         //!< NAG generator counter
+
+            NoiseState
+                (
+                const uint32_t  aSeed       //!< seed value
+                )
+                : gauss( aSeed )
+                , dek()
+                , nagKey( aSeed )
+                , nagCounter( 1 )
+            {
+            }
+        };
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RenderEngine
+            (
+            const uint32_t  aSampleRate,    //!< sample rate [Hz]
+            const uint32_t  aSeed           //!< seed value
+            );
+
+        void applyUpdate
+            (
+            LiveUpdate&     aUpdate         //!< update prepared by prepareUpdate(), receives the data of the update before
+            );
+
+        size_t getMemoryEstimate
+            (
+            const uint64_t  aNrOfSamples    //!< number of samples
+            ) const;
+
+        uint64_t getPosition() const;
+
+        uint32_t getSampleRate() const;
+
+        uint32_t getSeed() const;
+
+        const RenderStats& getStats() const;
+
+        bool lockMemory();
+
+        void prepareUpdate
+            (
+            const std::vector<SignalItem>&  aSignalsVector, //!< new signals vector
+            LiveUpdate&                     aUpdate         //!< prepared update
+            ) const;
+
+        static void quantize
+            (
+            const double*   aData,          //!< rendered samples
+            int16_t*        aSamples,       //!< 16 bit samples
+            const size_t    aCount          //!< number of samples
+            );
+
+        void render
+            (
+            double*         aData,          //!< output samples
+            const size_t    aCount          //!< number of samples
+            );
+
+        bool renderToWav
+            (
+            const std::string&  aFileName,          //!< output file name
+            const uint64_t      aNrOfSamples,       //!< number of samples
+            const uint64_t      aFirstSample = 0    //!< index of the first sample, multiple of CHUNK_ALIGNMENT
+            );
+
+        void reserve
+            (
+            const size_t    aMaxCount       //!< maximum number of samples rendered at once
+            );
+
+        void reset();
+
+        void resetStats();
+
+        void seek
+            (
+            const uint64_t  aPosition       //!< sample index
+            );
+
+        void setData
+            (
+            const std::vector<SignalItem*>& aSignalsVector  //!< signals vector
+            );
+
+        void setSeed
+            (
+            const uint32_t  aSeed           //!< seed value
+            );
+
+        void unlockMemory();
+
+        void updateData
+            (
+            const std::vector<SignalItem>&  aSignalsVector  //!< new signals vector
+            );
+
+    private:
+        void designNoiseFilters
+            (
+            const std::vector<SignalItem>&  aSignalsVector, //!< signals vector
+            std::vector<NoiseDesign>&       aDesignVec,     //!< distinct noise designs with a nonzero gamma, sorted
+            std::vector<NoisePwrSpectrum>&  aFilterVec      //!< filters of aDesignVec, except the pink noise one
+            ) const;
+
+        void fillNoiseBuffer
+            (
+            const SignalItem::SignalNoise&  aSignalData,    //!< Noise signal data
+            NoiseState&                     aNoiseState,    //!< state of the noise generators
+            double*                         aData,          //!< noise buffer
+            const size_t                    aCount          //!< number of samples
+            ) const;
+
+        void filterNoiseLanes
+            (
+            std::vector<double>&    aBuffer,    //!< total noise
+            const size_t            aCount      //!< number of samples
+            );
+
+        double generateRandomDek
+            (
+            DekState&       aState          //!< generator state
+            ) const;
+
+        double generateRandomNag
+            (
+            uint32_t        aKey,           //!< key
+            uint32_t&       aCounter        //!< counter, incremented
+            ) const;
+
+        static NoiseDesign getNoiseDesign
+            (
+            const SignalItem::SignalNoise&  aSignalData     //!< Noise signal data
+            );
+
+        uint64_t getFirstSampleAt
+            (
+            const double    aTime           //!< time
+            ) const;
+
+        double getSignalValue
+            (
+            const std::vector<SignalItem>&  aSignalsVector, //!< signals vector
+            const double                    aTime           //!< time
+            ) const;
+
+        double getSignalValueTriangle
+            (
+            const SignalItem::SignalTriangle    aSignalData,    //!< Triangle signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueRectangle
+            (
+            const SignalItem::SignalRectangle   aSignalData,    //!< Rectangle signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValuePulse
+            (
+            const SignalItem::SignalPulse       aSignalData,    //!< Pulse signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueRiseFall
+            (
+            const SignalItem::SignalRiseFall    aSignalData,    //!< RiseFall signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueSinDamp
+            (
+            const SignalItem::SignalSinDamp     aSignalData,    //!< SinDamp signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueSinRise
+            (
+            const SignalItem::SignalSinRise     aSignalData,    //!< SinRise signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueWavSin
+            (
+            const SignalItem::SignalWavSin      aSignalData,    //!< WavSin signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueAmSin
+            (
+            const SignalItem::SignalAmSin       aSignalData,    //!< AmSin signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueSinDampSin
+            (
+            const SignalItem::SignalSinDampSin  aSignalData,    //!< SinDampSin signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getSignalValueTrapDampSin
+            (
+            const SignalItem::SignalTrapDampSin aSignalData,    //!< TrapDampSin signal data
+            const double                        aTime           //!< time
+            ) const;
+
+        double getTime
+            (
+            const uint64_t  aSampleIndex    //!< sample index
+            ) const;
+
+        static void initRandomDek
+            (
+            DekState&       aState,         //!< generator state
+            const int32_t   aSeed           //!< seed value
+            );
+
+        static bool isPinkNoise
+            (
+            const NoiseDesign&  aDesign     //!< noise design
+            );
+
+        template<typename T>
+        static bool lockBuffer
+            (
+            std::vector<T>& aBuffer         //!< buffer
+            );
+
+        void pseudoDes
+            (
+            uint32_t*   lword,      //!< left word
+            uint32_t*   irword      //!< right word
+            ) const;
+
+        void renderNoise
+            (
+            const std::vector<SignalItem>&          aSignalsVector, //!< signals vector
+            const std::vector<NoiseDesign>&         aDesignVec,     //!< distinct noise designs of aSignalsVector with a nonzero gamma
+            const std::vector<NoisePwrSpectrum>&    aFilterVec,     //!< filters of aDesignVec, except the pink noise one
+            std::vector<double>&                    aBuffer,        //!< sum of the noise of all the items
+            const size_t                            aCount          //!< number of samples
+            );
+
+        void reserveBuffers();
+
+        size_t sumNoise
+            (
+            const std::vector<SignalItem>&  aSignalsVector, //!< signal items
+            const NoiseDesign&              aDesign,        //!< noise design
+            std::vector<double>&            aBuffer,        //!< sum of the noise items having aDesign
+            const size_t                    aCount          //!< number of samples
+            );
+
+        template<typename T>
+        static void unlockBuffer
+            (
+            std::vector<T>& aBuffer         //!< buffer
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        uint32_t                    mSampleRate;        //!< sample rate [Hz]
+        uint32_t                    mSeed;              //!< seed value
+        uint64_t                    mPosition;          //!< index of the next rendered sample
+        std::vector<SignalItem>     mSignalsVector;     //!< signals vector
+        std::vector<SignalItem>     mFadeSignalsVector; //!< previous signals, faded out in the next chunk after updateData()
+        std::vector<NoiseState>     mNoiseStateVec;     //!< noise generators, one per signal item
+        std::vector<NoiseState>     mSavedNoiseStateVec;    //!< noise generators before the fade noise is drawn
+        std::vector<NoiseDesign>    mNoiseDesignVec;    //!< distinct designs of the noise items with a nonzero gamma, sorted
+        std::vector<NoisePwrSpectrum>   mNoiseFilterVec;    //!< filters of mNoiseDesignVec, except the pink noise one
+        bool                        mFadeNoise;         //!< the noise of mFadeSignalsVector differs and is faded out too
+        std::vector<NoiseDesign>    mFadeNoiseDesignVec;    //!< noise designs of mFadeSignalsVector
+        std::vector<NoisePwrSpectrum>   mFadeNoiseFilterVec;    //!< filters of mFadeNoiseDesignVec
+        PinkNoise                   mPinkNoise;         //!< pink noise engine, for gamma = 1 with the default design
+        RenderStats                 mStats;             //!< time and bytes of the render stages
+        size_t                      mMaxCount;          //!< length reserved for the scratch buffers [samples]
+        std::vector<double>         mTotalNoiseBuffer;  //!< sum of the white and the filtered noise
+        std::vector<double>         mCrtNoiseBuffer;    //!< noise of one signal item
+        std::vector<double>         mFadeNoiseBuffer;   //!< total noise of mFadeSignalsVector
+        std::vector<std::vector<double>>    mDesignNoiseVec;    //!< white noise summed per design, one per mNoiseDesignVec entry
+        std::vector<std::vector<double>>    mFilteredNoiseVec;  //!< filtered noise, one per lane
+        std::vector<const NoisePwrSpectrum*>        mLaneFilterVec; //!< filters of the lanes being filtered
+        std::vector<const std::vector<double>*>     mLaneInVec;     //!< inputs of the lanes being filtered
+        std::vector<std::vector<double>*>           mLaneOutVec;    //!< outputs of the lanes being filtered
+};
+
+#endif // RenderEngine_h
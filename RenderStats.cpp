@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RenderStats.cpp
+This file contains the sources for the render stage statistics.
+*/
+
+#include "RenderStats.h"
+
+#include <cstdio>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RenderStats::RenderStats()
+{
+    reset();
+}
+
+
+//!************************************************************************
+//! Add the time and bytes of one run of a stage
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderStats::add
+    (
+    const Stage     aStage,         //!< stage
+    const uint64_t  aNanoseconds,   //!< time spent [ns]
+    const uint64_t  aBytes          //!< bytes produced
+    )
+{
+    mStageVec[aStage].nanoseconds += aNanoseconds;
+    mStageVec[aStage].bytes += aBytes;
+}
+
+
+//!************************************************************************
+//! Add the statistics of another render
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderStats::add
+    (
+    const RenderStats&  aStats      //!< statistics to add
+    )
+{
+    for( int s = 0; s < STAGE_COUNT; s++ )
+    {
+        add( static_cast<Stage>( s ), aStats.mStageVec[s].nanoseconds, aStats.mStageVec[s].bytes );
+    }
+}
+
+
+//!************************************************************************
+//! Get the time elapsed since a start time
+//!
+//! @returns: elapsed time [ns]
+//!************************************************************************
+uint64_t RenderStats::getNanosecondsSince
+    (
+    const Clock::time_point aStart  //!< start time
+    )
+{
+    return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - aStart ).count() );
+}
+
+
+//!************************************************************************
+//! Get the statistics of a stage
+//!
+//! @returns: time and bytes of the stage
+//!************************************************************************
+RenderStats::StageStats RenderStats::getStage
+    (
+    const Stage     aStage          //!< stage
+    ) const
+{
+    return mStageVec[aStage];
+}
+
+
+//!************************************************************************
+//! Get the short name of a stage
+//!
+//! @returns: the name
+//!************************************************************************
+const char* RenderStats::getStageName
+    (
+    const Stage     aStage          //!< stage
+    )
+{
+    static const char* const NAME_VEC[STAGE_COUNT] = { "synthesis", "noise", "filter", "quantize", "copy" };
+
+    return ( aStage < STAGE_COUNT ) ? NAME_VEC[aStage] : "";
+}
+
+
+//!************************************************************************
+//! Get the time spent in all the stages
+//!
+//! @returns: total time [ns]
+//!************************************************************************
+uint64_t RenderStats::getTotalNanoseconds() const
+{
+    uint64_t total = 0;
+
+    for( const auto& crtStage : mStageVec )
+    {
+        total += crtStage.nanoseconds;
+    }
+
+    return total;
+}
+
+
+//!************************************************************************
+//! Clear the statistics of all the stages
+//!
+//! @returns: nothing
+//!************************************************************************
+void RenderStats::reset()
+{
+    for( auto& crtStage : mStageVec )
+    {
+        crtStage.nanoseconds = 0;
+        crtStage.bytes = 0;
+    }
+}
+
+
+//!************************************************************************
+//! Format the statistics of the stages which ran, in ms and MB
+//!
+//! @returns: a line such as "synthesis 12.3 ms 3.53 MB, copy 0.4 ms 0.88 MB"
+//!************************************************************************
+std::string RenderStats::toString() const
+{
+    std::string text;
+
+    for( int s = 0; s < STAGE_COUNT; s++ )
+    {
+        if( mStageVec[s].nanoseconds || mStageVec[s].bytes )
+        {
+            char stageText[64];
+            snprintf( stageText, sizeof( stageText ), "%s%s %.1f ms %.2f MB",
+                      text.empty() ? "" : ", ",
+                      getStageName( static_cast<Stage>( s ) ),
+                      mStageVec[s].nanoseconds / 1e6,
+                      mStageVec[s].bytes / 1e6 );
+            text += stageText;
+        }
+    }
+
+    return text;
+}
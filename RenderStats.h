@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RenderStats.h
+This file contains the definitions for the render stage statistics.
+*/
+
+#ifndef RenderStats_h
+#define RenderStats_h
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+//************************************************************************
+// Class for accumulating the time spent and the bytes produced by each
+// stage of a render
+//
+// RenderEngine fills the synthesis and noise stages; the callers which
+// quantize the samples and copy them to their destination add the other
+// two. Statistics of several renders can be added together.
+//************************************************************************
+class RenderStats
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        typedef enum
+        {
+            STAGE_SYNTHESIS,            //!< deterministic signal items
+            STAGE_NOISE_GENERATION,     //!< white noise of the noise items
+            STAGE_NOISE_FILTERING,      //!< colouring of the noise
+            STAGE_QUANTIZATION,         //!< conversion to 16 bit samples
+            STAGE_COPY,                 //!< copy to the ring buffer, a file or from a cache entry
+
+            STAGE_COUNT
+        }Stage;
+
+        struct StageStats
+        {
+            uint64_t    nanoseconds;    //!< time spent in the stage [ns]
+            uint64_t    bytes;          //!< bytes produced by the stage
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RenderStats();
+
+        void add
+            (
+            const Stage     aStage,         //!< stage
+            const uint64_t  aNanoseconds,   //!< time spent [ns]
+            const uint64_t  aBytes          //!< bytes produced
+            );
+
+        void add
+            (
+            const RenderStats&  aStats      //!< statistics to add
+            );
+
+        static uint64_t getNanosecondsSince
+            (
+            const Clock::time_point aStart  //!< start time
+            );
+
+        StageStats getStage
+            (
+            const Stage     aStage          //!< stage
+            ) const;
+
+        static const char* getStageName
+            (
+            const Stage     aStage          //!< stage
+            );
+
+        uint64_t getTotalNanoseconds() const;
+
+        void reset();
+
+        std::string toString() const;
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        StageStats      mStageVec[STAGE_COUNT];     //!< statistics of each stage
+};
+
+#endif // RenderStats_h
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RingBuffer.cpp
+This file contains the sources for the single producer, single consumer ring buffer.
+*/
+
+#include "RingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "RealTime.h"
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RingBuffer::RingBuffer
+    (
+    const size_t    aCapacity       //!< capacity [samples], rounded up to a power of 2
+    )
+    : mMask( 0 )
+    , mReadPos( 0 )
+    , mWritePos( 0 )
+    , mMinFillLevel( 0 )
+    , mNrOfUnderruns( 0 )
+{
+    size_t capacity = 1;
+
+    while( capacity < aCapacity )
+    {
+        capacity <<= 1;
+    }
+
+    mSampleVec.resize( capacity );
+    mMask = capacity - 1;
+
+    reset();
+}
+
+
+//!************************************************************************
+//! Get the capacity
+//!
+//! @returns: number of samples
+//!************************************************************************
+size_t RingBuffer::getCapacity() const
+{
+    return mSampleVec.size();
+}
+
+
+//!************************************************************************
+//! Get the number of samples which can be read
+//! The value is exact for the consumer and a lower bound for the producer.
+//!
+//! @returns: number of samples
+//!************************************************************************
+size_t RingBuffer::getFillLevel() const
+{
+    return static_cast<size_t>( mWritePos.load( std::memory_order_acquire ) - mReadPos.load( std::memory_order_acquire ) );
+}
+
+
+//!************************************************************************
+//! Get the number of samples which can be written
+//! The value is exact for the producer and a lower bound for the consumer.
+//!
+//! @returns: number of samples
+//!************************************************************************
+size_t RingBuffer::getFreeSpace() const
+{
+    return getCapacity() - getFillLevel();
+}
+
+
+//!************************************************************************
+//! Get the lowest fill level found by a read since the last reset
+//!
+//! @returns: number of samples
+//!************************************************************************
+size_t RingBuffer::getMinFillLevel() const
+{
+    return mMinFillLevel.load( std::memory_order_relaxed );
+}
+
+
+//!************************************************************************
+//! Get the number of reads which found fewer samples than requested
+//!
+//! @returns: number of underruns since the last reset
+//!************************************************************************
+uint64_t RingBuffer::getNrOfUnderruns() const
+{
+    return mNrOfUnderruns.load( std::memory_order_relaxed );
+}
+
+
+//!************************************************************************
+//! Lock the storage in RAM, see RealTime::lockMemory()
+//!
+//! @returns: true if the storage was locked
+//!************************************************************************
+bool RingBuffer::lockMemory()
+{
+    return RealTime::lockMemory( mSampleVec.data(), mSampleVec.size() * sizeof( int16_t ) );
+}
+
+
+//!************************************************************************
+//! Read samples, consumer side
+//!
+//! @returns: number of samples read, less than aCount on underrun
+//!************************************************************************
+size_t RingBuffer::read
+    (
+    int16_t*        aSamples,       //!< destination
+    const size_t    aCount          //!< number of samples requested
+    )
+{
+    const uint64_t readPos = mReadPos.load( std::memory_order_relaxed );
+    const size_t fillLevel = static_cast<size_t>( mWritePos.load( std::memory_order_acquire ) - readPos );
+    const size_t count = std::min( aCount, fillLevel );
+
+    const size_t start = static_cast<size_t>( readPos & mMask );
+    const size_t firstPart = std::min( count, getCapacity() - start );
+
+    memcpy( aSamples, mSampleVec.data() + start, firstPart * sizeof( int16_t ) );
+    memcpy( aSamples + firstPart, mSampleVec.data(), ( count - firstPart ) * sizeof( int16_t ) );
+
+    mReadPos.store( readPos + count, std::memory_order_release );
+
+    if( fillLevel < mMinFillLevel.load( std::memory_order_relaxed ) )
+    {
+        mMinFillLevel.store( fillLevel, std::memory_order_relaxed );
+    }
+
+    if( count < aCount )
+    {
+        mNrOfUnderruns.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    return count;
+}
+
+
+//!************************************************************************
+//! Empty the buffer and clear the statistics
+//! Neither the producer nor the consumer may be running.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RingBuffer::reset()
+{
+    mReadPos.store( 0 );
+    mWritePos.store( 0 );
+    mMinFillLevel.store( getCapacity() );
+    mNrOfUnderruns.store( 0 );
+}
+
+
+//!************************************************************************
+//! Unlock the storage locked by lockMemory()
+//!
+//! @returns: nothing
+//!************************************************************************
+void RingBuffer::unlockMemory()
+{
+    RealTime::unlockMemory( mSampleVec.data(), mSampleVec.size() * sizeof( int16_t ) );
+}
+
+
+//!************************************************************************
+//! Write samples, producer side
+//!
+//! @returns: number of samples written, less than aCount if the buffer is full
+//!************************************************************************
+size_t RingBuffer::write
+    (
+    const int16_t*  aSamples,       //!< source
+    const size_t    aCount          //!< number of samples
+    )
+{
+    const uint64_t writePos = mWritePos.load( std::memory_order_relaxed );
+    const size_t freeSpace = getCapacity() - static_cast<size_t>( writePos - mReadPos.load( std::memory_order_acquire ) );
+    const size_t count = std::min( aCount, freeSpace );
+
+    const size_t start = static_cast<size_t>( writePos & mMask );
+    const size_t firstPart = std::min( count, getCapacity() - start );
+
+    memcpy( mSampleVec.data() + start, aSamples, firstPart * sizeof( int16_t ) );
+    memcpy( mSampleVec.data(), aSamples + firstPart, ( count - firstPart ) * sizeof( int16_t ) );
+
+    mWritePos.store( writePos + count, std::memory_order_release );
+
+    return count;
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RingBuffer.h
+This file contains the definitions for the single producer, single consumer ring buffer.
+*/
+
+#ifndef RingBuffer_h
+#define RingBuffer_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+//************************************************************************
+// Class for passing 16 bit samples from one producer thread to one
+// consumer thread
+//
+// The read and write positions are free running counters, each written
+// by one side only, so both write() and read() are wait-free: they never
+// lock and finish in a bounded number of steps. The consumer also keeps
+// statistics of the fill level and of the reads it could not satisfy.
+//************************************************************************
+class RingBuffer
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RingBuffer
+            (
+            const size_t    aCapacity       //!< capacity [samples], rounded up to a power of 2
+            );
+
+        size_t getCapacity() const;
+
+        size_t getFillLevel() const;
+
+        size_t getFreeSpace() const;
+
+        size_t getMinFillLevel() const;
+
+        uint64_t getNrOfUnderruns() const;
+
+        bool lockMemory();
+
+        size_t read
+            (
+            int16_t*        aSamples,       //!< destination
+            const size_t    aCount          //!< number of samples requested
+            );
+
+        void reset();
+
+        void unlockMemory();
+
+        size_t write
+            (
+            const int16_t*  aSamples,       //!< source
+            const size_t    aCount          //!< number of samples
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<int16_t>    mSampleVec;         //!< storage
+        size_t                  mMask;              //!< capacity - 1
+
+        std::atomic<uint64_t>   mReadPos;           //!< samples read so far, written by the consumer
+        std::atomic<uint64_t>   mWritePos;          //!< samples written so far, written by the producer
+
+        std::atomic<size_t>     mMinFillLevel;      //!< lowest fill level seen by the consumer
+        std::atomic<uint64_t>   mNrOfUnderruns;     //!< number of reads which found too few samples
+};
+
+#endif // RingBuffer_h
@@ -25,6 +25,8 @@ This file contains the definitions for a signal item.
 
 #include <cstdint>
 
+#include "NoisePwrSpectrum.h"
+
 
 //************************************************************************
 // Class for handling a signal item
@@ -331,7 +333,10 @@ class SignalItem
         typedef enum
         {
             NOISE_TYPE_DEK,
-            NOISE_TYPE_NAG
+            NOISE_TYPE_NAG,
+            NOISE_TYPE_GAUSS,
+
+            NOISE_TYPE_COUNT
         }NoiseType;
 
         struct SignalNoise
@@ -342,9 +347,12 @@ class SignalItem
             double      gamma;
             double      tDelay;
 
-            double      amplit;
+            double      amplit;     //!< peak value for DEK and NAG, RMS value for GAUSS
             double      offset;
 
+            int         nrOfBlocks;     //!< number of blocks of the noise filter
+            double      poleDensity;    //!< poles / decade of the noise filter
+
             SignalNoise()
             {
                 type = SIGNAL_TYPE_NOISE;
@@ -355,6 +363,9 @@ class SignalItem
 
                 amplit = 0.1;
                 offset = 0;
+
+                nrOfBlocks = NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS;
+                poleDensity = NoisePwrSpectrum::DEFAULT_POLE_DENSITY;
             }
         };
 
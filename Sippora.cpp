@@ -24,12 +24,19 @@ This file contains the sources for the signal generator.
 #include "./ui_Sippora.h"
 
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QStandardPaths>
 
 #include <algorithm>
+#include <limits>
 #include <iostream>
 #include <fstream>
 
 #include "NoisePwrSpectrum.h"
+#include "PresetFile.h"
+#include "RealTime.h"
+#include "RenderCache.h"
+#include "RenderEngine.h"
 
 
 //!************************************************************************
@@ -44,14 +51,17 @@ Sippora::Sippora
     , mAboutUi( new Ui::AboutDialog )
     , mSignalUndefined( true )
     , mSignalReady( false )
+    , mSignalUnsaved( false )
     , mSignalStarted( false )
     , mSignalPaused( false )
     , mEditedSignal( nullptr )
     , mIsSignalEdited( false )
     , mAudioBufferLength( 30 )
+    , mBufferLengthTimer( new QTimer( this ) )
     , mAudioBufferProgress( 0 )
     , mAudioBufferTimer( new QTimer( this ) )
     , mAudioBufferCounter( 0 )
+    , mRenderStatsLabel( new QLabel( this ) )
 {
     mMainUi->setupUi( this );
 
@@ -174,6 +184,27 @@ Sippora::Sippora
     connect( mMainUi->NoiseAmplitEdit, &QLineEdit::editingFinished, this, &Sippora::handleSignalChangedNoiseAmplitude );
     connect( mMainUi->NoiseOffsetEdit, &QLineEdit::editingFinished, this, &Sippora::handleSignalChangedNoiseOffset );
 
+    // Live update of the edited item while generating, after the handlers above
+    for( auto& crtEdit : mMainUi->SignalTypesTab->findChildren<QLineEdit*>() )
+    {
+        connect( crtEdit, &QLineEdit::editingFinished, this, &Sippora::handleSignalParameterEdited );
+    }
+
+    for( auto& crtSpin : mMainUi->SignalTypesTab->findChildren<QSpinBox*>() )
+    {
+        connect( crtSpin, SIGNAL( valueChanged(int) ), this, SLOT( handleSignalParameterEdited() ) );
+    }
+
+    for( auto& crtSpin : mMainUi->SignalTypesTab->findChildren<QDoubleSpinBox*>() )
+    {
+        connect( crtSpin, SIGNAL( valueChanged(double) ), this, SLOT( handleSignalParameterEdited() ) );
+    }
+
+    for( auto& crtComboBox : mMainUi->SignalTypesTab->findChildren<QComboBox*>() )
+    {
+        connect( crtComboBox, SIGNAL( currentIndexChanged(int) ), this, SLOT( handleSignalParameterEdited() ) );
+    }
+
 
     // Add/Replace button
     connect( mMainUi->SignalItemActionButton, SIGNAL( clicked() ), this, SLOT( handleAddReplaceSignal() ) );
@@ -210,13 +241,24 @@ Sippora::Sippora
 
     mMainUi->BufferLengthSpin->setRange( 2, 3600 );
     mMainUi->BufferLengthSpin->setValue( mAudioBufferLength );
-    connect( mMainUi->BufferLengthSpin, SIGNAL( valueChanged(int) ), this, SLOT( handleAudioBufferLengthChanged(int) ) );
+    // spinning through many values applies only the last one
+    mBufferLengthTimer->setSingleShot( true );
+    mBufferLengthTimer->setInterval( BUFFER_LENGTH_DELAY_MS );
+    connect( mMainUi->BufferLengthSpin, SIGNAL( valueChanged(int) ), mBufferLengthTimer, SLOT( start() ) );
+    connect( mBufferLengthTimer, SIGNAL( timeout() ), this, SLOT( handleAudioBufferLengthChanged() ) );
+
+    mMainUi->StartAtSpin->setRange( 0, mAudioBufferLength - 1 );
+    mMainUi->StartAtSpin->setValue( 0 );
+    connect( mMainUi->StartAtSpin, &QSpinBox::editingFinished, this, &Sippora::handleGenerateStartAtChanged );
 
     mMainUi->BufferProgressBar->setRange( 0, 100 );
     mMainUi->BufferProgressBar->setValue( mAudioBufferProgress );
 
     connect( mAudioBufferTimer, SIGNAL( timeout() ), this, SLOT( updateAudioBufferTimer() ) );
 
+    mRenderStatsLabel->setToolTip( "Time spent and bytes produced by each stage of the last render" );
+    mMainUi->statusbar->addPermanentWidget( mRenderStatsLabel );
+
     if( !initializeAudio( QAudioDeviceInfo::defaultOutputDevice() ) )
     {
         QMessageBox::warning( this,
@@ -230,6 +272,7 @@ Sippora::Sippora
     connect( mMainUi->GenerateStartButton, SIGNAL( clicked() ), this, SLOT( handleGenerateStart() ) );
     connect( mMainUi->GeneratePauseButton, SIGNAL( clicked() ), this, SLOT( handleGeneratePauseResume() ) );
     connect( mMainUi->GenerateStopButton, SIGNAL( clicked() ), this, SLOT( handleGenerateStop() ) );
+    connect( mMainUi->GenerateRealTimeCheckBox, &QCheckBox::toggled, this, &Sippora::handleGenerateRealTimeToggled );
 
     connect( mMainUi->GenerateVolumeSlider, &QSlider::valueChanged, this, &Sippora::handleVolumeChanged );
 
@@ -238,6 +281,7 @@ Sippora::Sippora
     //****************************************
     connect( mMainUi->actionNew, &QAction::triggered, this, &Sippora::handleSignalNew );
     connect( mMainUi->actionOpen, &QAction::triggered, this, &Sippora::handleSignalOpen );
+    connect( mMainUi->actionRenderWav, &QAction::triggered, this, &Sippora::handleSignalRenderWav );
     connect( mMainUi->actionExit, &QAction::triggered, this, &Sippora::handleExit );
 
     connect( mMainUi->actionAbout, &QAction::triggered, this, &Sippora::handleAbout );
@@ -262,6 +306,136 @@ Sippora::~Sippora()
 }
 
 
+//!************************************************************************
+//! Create a signal item from the values of the signals tabs, with the
+//! type of the edited item
+//!
+//! @returns: the signal item
+//!************************************************************************
+SignalItem Sippora::createEditedSignalItem() const
+{
+    SignalItem item = *mEditedSignal;
+
+    switch( mEditedSignal->getType() )
+    {
+        case SignalItem::SIGNAL_TYPE_TRIANGLE:
+            item = SignalItem( mSignalTriangle );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:
+            item = SignalItem( mSignalRectangle );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_PULSE:
+            item = SignalItem( mSignalPulse );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RISEFALL:
+            item = SignalItem( mSignalRiseFall );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMP:
+            item = SignalItem( mSignalSinDamp );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINRISE:
+            item = SignalItem( mSignalSinRise );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_WAVSIN:
+            item = SignalItem( mSignalWavSin );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_AMSIN:
+            item = SignalItem( mSignalAmSin );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+            item = SignalItem( mSignalSinDampSin );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+            item = SignalItem( mSignalTrapDampSin );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_NOISE:
+            item = SignalItem( mSignalNoise );
+            break;
+
+        default:
+            break;
+    }
+
+    return item;
+}
+
+
+//!************************************************************************
+//! Format a string for any signal item
+//!
+//! @returns signal string with comma separated parameters
+//!************************************************************************
+QString Sippora::createSignalString
+    (
+    const SignalItem*                   aSignal     //!< a signal item
+    ) const
+{
+    QString lineString;
+
+    switch( aSignal->getType() )
+    {
+        case SignalItem::SIGNAL_TYPE_TRIANGLE:
+            lineString = createSignalStringTriangle( aSignal->getSignalDataTriangle() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RECTANGLE:
+            lineString = createSignalStringRectangle( aSignal->getSignalDataRectangle() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_PULSE:
+            lineString = createSignalStringPulse( aSignal->getSignalDataPulse() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_RISEFALL:
+            lineString = createSignalStringRiseFall( aSignal->getSignalDataRiseFall() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMP:
+            lineString = createSignalStringSinDamp( aSignal->getSignalDataSinDamp() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINRISE:
+            lineString = createSignalStringSinRise( aSignal->getSignalDataSinRise() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_WAVSIN:
+            lineString = createSignalStringWavSin( aSignal->getSignalDataWavSin() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_AMSIN:
+            lineString = createSignalStringAmSin( aSignal->getSignalDataAmSin() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
+            lineString = createSignalStringSinDampSin( aSignal->getSignalDataSinDampSin() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
+            lineString = createSignalStringTrapDampSin( aSignal->getSignalDataTrapDampSin() );
+            break;
+
+        case SignalItem::SIGNAL_TYPE_NOISE:
+            lineString = createSignalStringNoise( aSignal->getSignalDataNoise() );
+            break;
+
+        default:
+            break;
+    }
+
+    return lineString;
+}
+
+
 //!************************************************************************
 //! Format a string for Triangle signals
 //!
@@ -495,6 +669,15 @@ QString Sippora::createSignalStringNoise
     lineString += SUBSTR_DELIMITER + QString::number( aSignal.amplit );
     lineString += SUBSTR_DELIMITER + QString::number( aSignal.offset );
 
+    // the filter design is optional, see PresetFile
+    if( NoisePwrSpectrum::DEFAULT_NR_OF_FILTER_BLOCKS != aSignal.nrOfBlocks
+     || NoisePwrSpectrum::DEFAULT_POLE_DENSITY != aSignal.poleDensity
+      )
+    {
+        lineString += SUBSTR_DELIMITER + QString::number( aSignal.nrOfBlocks );
+        lineString += SUBSTR_DELIMITER + QString::number( aSignal.poleDensity );
+    }
+
     return lineString;
 }
 
@@ -693,17 +876,30 @@ void Sippora::fillValuesNoise()
 }
 
 
+//!************************************************************************
+//! Get the render stages of the last render: the current or last
+//! playback since its start, or the last file rendered
+//!
+//! @returns: the statistics
+//!************************************************************************
+RenderStats Sippora::getLastRenderStats() const
+{
+    return mLastRenderStats;
+}
+
+
 //!************************************************************************
 //! Handle for changing the audio buffer length (seconds)
+//! Called once the spin box has settled, or before the length is used.
+//! The audio source applies it at the next start.
 //!
 //! @returns nothing
 //!************************************************************************
-/* slot */ void Sippora::handleAudioBufferLengthChanged
-    (
-    int aValue      //!< value
-    )
+/* slot */ void Sippora::handleAudioBufferLengthChanged()
 {
-    mAudioBufferLength = aValue;
+    mBufferLengthTimer->stop();
+    mAudioBufferLength = mMainUi->BufferLengthSpin->value();
+    mMainUi->StartAtSpin->setMaximum( mAudioBufferLength - 1 );
 
     if( mAudioSrc )
     {
@@ -728,6 +924,7 @@ void Sippora::fillValuesNoise()
 
 //!************************************************************************
 //! Handle for changing the audio device
+//! While generating, playback continues on the new device.
 //!
 //! @returns nothing
 //!************************************************************************
@@ -736,20 +933,47 @@ void Sippora::handleDeviceChanged
     int     aIndex      //!< index
     )
 {
+    const AudioSource* previousAudioSrc = mAudioSrc.data();
+
     mAudioOutput->stop();
     mAudioOutput->disconnect( this );
 
-    if( mAudioSrc )
+    initializeAudio( mMainUi->GenerateDeviceComboBox->itemData( aIndex ).value<QAudioDeviceInfo>() );
+
+    if( mAudioSrc.data() == previousAudioSrc )
     {
-        mAudioSrc->stop();
+        // same format: only the sink is reopened, the signal is kept
+        if( mSignalStarted )
+        {
+            if( !mAudioSrc->isStarted() )
+            {
+                mAudioSrc->start();
+            }
+
+            mAudioOutput->start( mAudioSrc.data() );
+            mSignalStarted = ( QAudio::ActiveState == mAudioOutput->state() );
+            mSignalPaused = false;
+        }
     }
+    else
+    {
+        mSignalStarted = false;
+        mSignalPaused = false;
 
-    initializeAudio( mMainUi->GenerateDeviceComboBox->itemData( aIndex ).value<QAudioDeviceInfo>() );
+        if( mSignalReady )
+        {
+            setAudioData();
+        }
+    }
 
-    if( mSignalReady )
+    if( !mSignalStarted )
     {
-        setAudioData();
+        mAudioBufferCounter = 0;
+        updateAudioBufferTimer();
+        mAudioBufferTimer->stop();
     }
+
+    updateControls();
 }
 
 
@@ -1000,13 +1224,22 @@ void Sippora::handleDeviceChanged
             mEditedSignal = nullptr;
             mIsSignalEdited = false;
 
-            mSignalReady = false;
-
-            if( mAudioSrc )
+            if( mSignalStarted )
             {
-                if( mAudioSrc->isOpen() )
+                // already heard live, keep generating, but the saved file is outdated
+                mSignalUnsaved = true;
+                publishLiveData();
+            }
+            else
+            {
+                mSignalReady = false;
+
+                if( mAudioSrc )
                 {
-                    mAudioSrc->stop();
+                    if( mAudioSrc->isOpen() )
+                    {
+                        mAudioSrc->stop();
+                    }
                 }
             }
         }
@@ -1139,92 +1372,50 @@ void Sippora::handleDeviceChanged
 //!************************************************************************
 /* slot */ void Sippora::handleSaveSignal()
 {
+    const QString BINARY_FILTER = "Binary presets (*" + QString::fromStdString( PresetFile::BINARY_EXTENSION ) + ")";
+
     QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName( this,
                                                      "Save active signal",
                                                      "",
-                                                     "Text files (*.txt);;All files (*)",
+                                                     "Text files (*.txt);;" + BINARY_FILTER + ";;All files (*)",
                                                      &selectedFilter,
                                                      QFileDialog::DontUseNativeDialog
                                                     );
 
     std::string outputFilename = fileName.toStdString();
-    std::ofstream outputFile;
-    outputFile.open( outputFilename );
+    bool status = false;
 
-    if( outputFile.is_open() )
+    if( fileName.size()
+     && ( BINARY_FILTER == selectedFilter || fileName.endsWith( QString::fromStdString( PresetFile::BINARY_EXTENSION ), Qt::CaseInsensitive ) )
+      )
     {
-        for( size_t i = 0; i < mSignalsVector.size(); i++ )
-        {
-            SignalItem::SignalType sigType = mSignalsVector.at( i )->getType();
-            QString lineString;
+        status = PresetFile::writeBinary( outputFilename, mSignalsVector );
+    }
+    else
+    {
+        std::ofstream outputFile;
+        outputFile.open( outputFilename );
+        status = outputFile.is_open();
 
-            switch( sigType )
+        if( status )
+        {
+            for( size_t i = 0; i < mSignalsVector.size(); i++ )
             {
-                case SignalItem::SIGNAL_TYPE_TRIANGLE:
-                    lineString = createSignalStringTriangle( mSignalsVector.at( i )->getSignalDataTriangle() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_RECTANGLE:
-                    lineString = createSignalStringRectangle( mSignalsVector.at( i )->getSignalDataRectangle() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_PULSE:
-                    lineString = createSignalStringPulse( mSignalsVector.at( i )->getSignalDataPulse() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_RISEFALL:
-                    lineString = createSignalStringRiseFall( mSignalsVector.at( i )->getSignalDataRiseFall() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_SINDAMP:
-                    lineString = createSignalStringSinDamp( mSignalsVector.at( i )->getSignalDataSinDamp() );
-                    lineString += "\n";
-                    break;
+                QString lineString = createSignalString( mSignalsVector.at( i ) );
+                lineString += "\n";
 
-                case SignalItem::SIGNAL_TYPE_SINRISE:
-                    lineString = createSignalStringSinRise( mSignalsVector.at( i )->getSignalDataSinRise() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_WAVSIN:
-                    lineString = createSignalStringWavSin( mSignalsVector.at( i )->getSignalDataWavSin() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_AMSIN:
-                    lineString = createSignalStringAmSin( mSignalsVector.at( i )->getSignalDataAmSin() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
-                    lineString = createSignalStringSinDampSin( mSignalsVector.at( i )->getSignalDataSinDampSin() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
-                    lineString = createSignalStringTrapDampSin( mSignalsVector.at( i )->getSignalDataTrapDampSin() );
-                    lineString += "\n";
-                    break;
-
-                case SignalItem::SIGNAL_TYPE_NOISE:
-                    lineString = createSignalStringNoise( mSignalsVector.at( i )->getSignalDataNoise() );
-                    lineString += "\n";
-                    break;
-
-                default:
-                    break;
+                outputFile << lineString.toStdString();
             }
 
-            outputFile << lineString.toStdString();
+            outputFile.close();
         }
+    }
 
-        outputFile.close();
+    if( status )
+    {
         mSignalReady = true;
+        mSignalUnsaved = false;
 
         setAudioData();
 
@@ -1275,7 +1466,7 @@ void Sippora::handleDeviceChanged
 {
     bool canExit = true;
 
-    if( !mSignalUndefined && !mSignalReady )
+    if( !mSignalUndefined && ( !mSignalReady || mSignalUnsaved ) )
     {
         QMessageBox::StandardButton choice = QMessageBox::question( this,
                                                                    "Exit",
@@ -1300,6 +1491,11 @@ void Sippora::handleDeviceChanged
 //!************************************************************************
 void Sippora::handleGenerateStart()
 {
+    if( mBufferLengthTimer->isActive() )
+    {
+        handleAudioBufferLengthChanged();
+    }
+
     if( QAudio::StoppedState != mAudioOutput->state() )
     {
         mAudioOutput->stop();
@@ -1321,14 +1517,59 @@ void Sippora::handleGenerateStart()
 
     if( mSignalStarted )
     {
-        mAudioBufferCounter = 0;
+        mAudioBufferCounter = mMainUi->StartAtSpin->value();
         mAudioBufferTimer->start( TIMER_PER_MS );
+
+        if( mMainUi->GenerateRealTimeCheckBox->isChecked() )
+        {
+            mMainUi->statusbar->showMessage( "Real-time guarantees: "
+                                             + QString::fromStdString( RealTime::describe( mAudioSrc->getRealTimeGuarantees() ) ),
+                                             TIMER_PER_MS * 5 );
+        }
     }
 
     updateControls();
 }
 
 
+//!************************************************************************
+//! Handle for requesting real-time playback
+//! Takes effect at the next start.
+//!
+//! @returns: nothing
+//!************************************************************************
+void Sippora::handleGenerateRealTimeToggled
+    (
+    bool    aChecked    //!< checked state
+    )
+{
+    if( mAudioSrc )
+    {
+        mAudioSrc->setRealTime( aChecked );
+    }
+}
+
+
+//!************************************************************************
+//! Handle for changing the start position
+//! While generating, playback jumps to the new position at once.
+//!
+//! @returns: nothing
+//!************************************************************************
+void Sippora::handleGenerateStartAtChanged()
+{
+    if( mAudioSrc )
+    {
+        mAudioSrc->seek( static_cast<uint64_t>( mMainUi->StartAtSpin->value() ) * AUDIO_SAMPLE_RATE );
+
+        if( mSignalStarted )
+        {
+            mAudioBufferCounter = mMainUi->StartAtSpin->value();
+        }
+    }
+}
+
+
 //!************************************************************************
 //! Pause generating signals
 //!
@@ -1399,6 +1640,7 @@ void Sippora::handleGenerateStop()
     {
         mSignalUndefined = false;
         mSignalReady = false;
+        mSignalUnsaved = false;
         mSignalStarted = false;
         mSignalPaused = false;
         mIsSignalEdited = false;
@@ -1425,7 +1667,7 @@ void Sippora::handleGenerateStop()
 //!************************************************************************
 /* slot */ void Sippora::handleSignalOpen()
 {
-    if( !mSignalUndefined && !mSignalReady )
+    if( !mSignalUndefined && ( !mSignalReady || mSignalUnsaved ) )
     {
         QString msg = "Please save the current signal first.";
         QMessageBox msgBox;
@@ -1443,6 +1685,7 @@ void Sippora::handleGenerateStop()
     {
         mSignalUndefined = true;
         mSignalReady = false;
+        mSignalUnsaved = false;
         mSignalStarted = false;
         mSignalPaused = false;
         mIsSignalEdited = false;
@@ -1461,935 +1704,32 @@ void Sippora::handleGenerateStop()
         QString fileName = QFileDialog::getOpenFileName( this,
                                                          "Open signal file",
                                                          "",
-                                                         "Text files (*.txt);;All files (*)",
+                                                         "Presets (*.txt *" + QString::fromStdString( PresetFile::BINARY_EXTENSION ) + ");;All files (*)",
                                                          &selectedFilter,
                                                          QFileDialog::DontUseNativeDialog
                                                         );
 
         std::string inputFilename = fileName.toStdString();
-        std::ifstream inputFile( inputFilename );
+        size_t nrOfInvalid = 0;
 
-        if( inputFile.is_open() )
+        if( PresetFile::read( inputFilename, mSignalsVector, &nrOfInvalid ) )
         {
-            const std::string DELIM = ", ";
-            std::string currentLine;
-
+            // populate the model at once, not row by row
+            QStringList signalStringList;
+            signalStringList.reserve( static_cast<int>( mSignalsVector.size() ) );
 
-            while( getline( inputFile, currentLine ) )
+            for( size_t i = 0; i < mSignalsVector.size(); i++ )
             {
-                std::vector<QString> substringsVec;
-                size_t pos = 0;
-
-                while( ( pos = currentLine.find( DELIM ) ) != std::string::npos )
-                {
-                    substringsVec.push_back( QString::fromStdString( currentLine.substr( 0, pos ) ) );
-                    currentLine.erase( 0, pos + DELIM.length() );
-                }
-
-                if( currentLine.size() )
-                {
-                    substringsVec.push_back( QString::fromStdString( currentLine ) );
-                }
-
-                size_t ssCount = substringsVec.size();
-
-                if( ssCount >=2 )
-                {
-                    bool currentSignalOk = true;
-                    size_t expectedParams = 0;
-
-                    QString lineString;
-
-                    double crtDbl = 0;
-                    int crtInt = 0;
-
-                    SignalItem::SignalType sigType = static_cast<SignalItem::SignalType>( substringsVec[0].toInt() );
-                    SignalItem* crtSignal = nullptr;
-
-                    switch( sigType )
-                    {
-                        case SignalItem::SIGNAL_TYPE_TRIANGLE:
-                            {
-                                expectedParams = 6;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalTriangle sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tPeriod = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tRise = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tFall = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMax = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMin = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringTriangle( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_RECTANGLE:
-                            {
-                                expectedParams = 5;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalRectangle sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tPeriod = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.fillFactor = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMax = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMin = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringRectangle( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_PULSE:
-                            {
-                                expectedParams = 7;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalPulse sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tPeriod = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tRise = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tWidth = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tFall = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMax = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[7].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMin = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringPulse( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_RISEFALL:
-                            {
-                                expectedParams = 7;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalRiseFall sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelayRise = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tRampRise = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelayFall = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tRampFall = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMax = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[7].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.yMin = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringRiseFall( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_SINDAMP:
-                            {
-                                expectedParams = 6;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalSinDamp sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.freqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.phiRad = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.damping = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringSinDamp( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_SINRISE:
-                            {
-                                expectedParams = 7;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalSinRise sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.freqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.phiRad = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tEnd = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[7].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.damping = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringSinRise( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_WAVSIN:
-                            {
-                                expectedParams = 6;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalWavSin sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.freqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.phiRad = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtInt = substringsVec[6].toInt( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.index = crtInt;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringWavSin( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_AMSIN:
-                            {
-                                expectedParams = 7;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalAmSin sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.carrierFreqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.carrierAmplitude = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.carrierOffset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.carrierTDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.modulationFreqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.modulationPhiRad = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[7].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.modulationIndex = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringAmSin( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_SINDAMPSIN:
-                            {
-                                expectedParams = 6;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalSinDampSin sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.freqSinHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tPeriodEnv = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtInt = substringsVec[6].toInt( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.dampingType = crtInt;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringSinDampSin( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_TRAPDAMPSIN:
-                            {
-                                expectedParams = 9;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalTrapDampSin sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[1].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tPeriod = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tRise = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tWidth = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tFall = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[6].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tCross = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[7].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.freqHz = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[8].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[9].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringTrapDampSin( sig );
-                                }
-                            }
-                            break;
-
-                        case SignalItem::SIGNAL_TYPE_NOISE:
-                            {
-                                expectedParams = 5;
-                                currentSignalOk = ( expectedParams == ( ssCount - 1 ) );
-                                SignalItem::SignalNoise sig;
-
-                                if( currentSignalOk )
-                                {
-                                    crtInt = substringsVec[1].toInt( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.noiseType = static_cast<SignalItem::NoiseType>( crtInt );
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[2].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.gamma = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[3].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.tDelay = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[4].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.amplit = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtDbl = substringsVec[5].toDouble( &currentSignalOk );
-
-                                    if( currentSignalOk )
-                                    {
-                                        sig.offset = crtDbl;
-                                    }
-                                }
-
-                                if( currentSignalOk )
-                                {
-                                    crtSignal = new SignalItem( sig );
-                                    lineString = createSignalStringNoise( sig );
-                                }
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
+                signalStringList.append( createSignalString( mSignalsVector.at( i ) ) );
+            }
 
-                    if( crtSignal && currentSignalOk )
-                    {
-                        mSignalsVector.push_back( crtSignal );
+            mSignalsListModel.setStringList( signalStringList );
 
-                        int row = mSignalsListModel.rowCount();
-                        mSignalsListModel.insertRow( row );
-                        QModelIndex index = mSignalsListModel.index( row );
-                        mSignalsListModel.setData( index, lineString );
-                    }
-                }
+            if( nrOfInvalid )
+            {
+                mMainUi->statusbar->showMessage( QString( "%1 invalid line(s) skipped" ).arg( nrOfInvalid ), TIMER_PER_MS * 5 );
             }
 
-            inputFile.close();
-
             if( mSignalsVector.size() )
             {
                 mSignalUndefined = false;
@@ -2418,6 +1758,68 @@ void Sippora::handleGenerateStop()
 }
 
 
+//!************************************************************************
+//! Render the active signal to a WAV file
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void Sippora::handleSignalRenderWav()
+{
+    if( mBufferLengthTimer->isActive() )
+    {
+        handleAudioBufferLengthChanged();
+    }
+
+    bool ok = false;
+    int seconds = QInputDialog::getInt( this,
+                                        "Render to WAV",
+                                        "Length [seconds]:",
+                                        mAudioBufferLength,
+                                        1,
+                                        std::numeric_limits<int>::max(),
+                                        1,
+                                        &ok
+                                       );
+
+    if( ok )
+    {
+        QString selectedFilter;
+        QString fileName = QFileDialog::getSaveFileName( this,
+                                                         "Render signal to WAV file",
+                                                         "",
+                                                         "WAV files (*.wav);;All files (*)",
+                                                         &selectedFilter,
+                                                         QFileDialog::DontUseNativeDialog
+                                                        );
+
+        if( fileName.size() )
+        {
+            // same seed as playback, so the file holds the samples which are heard
+            RenderEngine renderEngine( AUDIO_SAMPLE_RATE, RenderCache::getSeed( RenderCache::hashItems( mSignalsVector ) ) );
+            renderEngine.setData( mSignalsVector );
+
+            QApplication::setOverrideCursor( Qt::WaitCursor );
+            bool status = renderEngine.renderToWav( fileName.toStdString(), static_cast<uint64_t>( seconds ) * AUDIO_SAMPLE_RATE );
+            QApplication::restoreOverrideCursor();
+
+            showRenderStats( renderEngine.getStats() );
+
+            if( status )
+            {
+                mMainUi->statusbar->showMessage( "Rendered " + QString::number( seconds ) + " s to \"" + fileName + "\".", TIMER_PER_MS * 5 );
+            }
+            else
+            {
+                QString msg = "Could not write file \"" + fileName +"\".";
+                QMessageBox msgBox;
+                msgBox.setText( msg );
+                msgBox.exec();
+            }
+        }
+    }
+}
+
+
 //!************************************************************************
 //! Handle for changing parameters for Triangle
 //! *** TPeriod ***
@@ -4529,6 +3931,21 @@ void Sippora::handleSignalChangedNoiseGamma
 }
 
 
+//!************************************************************************
+//! Handle for any parameter change in the signals tabs
+//! While generating, the edited item is heard with its new parameters.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void Sippora::handleSignalParameterEdited()
+{
+    if( mIsSignalEdited )
+    {
+        publishLiveData();
+    }
+}
+
+
 //!************************************************************************
 //! Update items required when changing the signal type
 //!
@@ -4556,6 +3973,7 @@ void Sippora::handleSignalChangedNoiseGamma
     {
         mEditedSignal = nullptr;
         mIsSignalEdited = false;
+        publishLiveData();      // drop the live changes
         updateControls();
     }
 }
@@ -4582,6 +4000,9 @@ void Sippora::handleSignalChangedNoiseGamma
 
 //!************************************************************************
 //! Initialize the audio device
+//! The audio source is replaced only when the format the output is opened
+//! with changes, so switching between devices keeps the signal and its
+//! rendered samples.
 //!
 //! @returns: true if audio device can be initialized with required parameters
 //!************************************************************************
@@ -4592,7 +4013,7 @@ bool Sippora::initializeAudio
 {
     bool status = false;
     QAudioFormat format;
-    format.setSampleRate( 44100 );
+    format.setSampleRate( AUDIO_SAMPLE_RATE );
     format.setChannelCount( 1 );
     format.setSampleSize( 16 );
     format.setCodec( "audio/pcm" );
@@ -4601,9 +4022,20 @@ bool Sippora::initializeAudio
 
     status = aDeviceInfo.isFormatSupported( format );
 
-    mAudioSrc.reset( new AudioSource( format, mAudioBufferLength ) );
     mAudioOutput.reset( new QAudioOutput( aDeviceInfo, format ) );
 
+    // the audio source, with its signal, is kept as long as the output
+    // is opened with the same format
+    const QAudioFormat outputFormat = mAudioOutput->format();
+
+    if( !mAudioSrc || mAudioSrc->getFormat() != outputFormat )
+    {
+        mAudioSrc.reset( new AudioSource( outputFormat, mAudioBufferLength ) );
+        mAudioSrc->setCacheDirectory( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ).toStdString() + "/renders" );
+        mAudioSrc->setRealTime( mMainUi->GenerateRealTimeCheckBox->isChecked() );
+        mAudioSrc->seek( static_cast<uint64_t>( mMainUi->StartAtSpin->value() ) * outputFormat.sampleRate() );
+    }
+
     qreal initialVolume = QAudio::convertVolume( mAudioOutput->volume(),
                                                  QAudio::LinearVolumeScale,
                                                  QAudio::LogarithmicVolumeScale );
@@ -4616,6 +4048,29 @@ bool Sippora::initializeAudio
 }
 
 
+//!************************************************************************
+//! Publish the current parameters to the audio source while generating
+//! The edited item, if any, is taken from the signals tabs.
+//!
+//! @returns: nothing
+//!************************************************************************
+void Sippora::publishLiveData()
+{
+    if( mAudioSrc && mSignalStarted )
+    {
+        const int editedRow = ( mIsSignalEdited && mEditedSignal ) ? mMainUi->ActiveSignalList->currentIndex().row() : -1;
+        std::vector<SignalItem> liveVector;
+
+        for( size_t i = 0; i < mSignalsVector.size(); i++ )
+        {
+            liveVector.push_back( ( static_cast<int>( i ) == editedRow ) ? createEditedSignalItem() : *mSignalsVector.at( i ) );
+        }
+
+        mAudioSrc->setLiveData( liveVector );
+    }
+}
+
+
 //!************************************************************************
 //! Set the audio data
 //!
@@ -4630,6 +4085,21 @@ void Sippora::setAudioData()
 }
 
 
+//!************************************************************************
+//! Show the render stages of the last render in the status bar
+//!
+//! @returns: nothing
+//!************************************************************************
+void Sippora::showRenderStats
+    (
+    const RenderStats&          aStats          //!< statistics of the last render
+    )
+{
+    mLastRenderStats = aStats;
+    mRenderStatsLabel->setText( QString::fromStdString( aStats.toString() ) );
+}
+
+
 //!************************************************************************
 //! Update on audio buffer timer timeout
 //!
@@ -4650,6 +4120,18 @@ void Sippora::updateAudioBufferTimer()
     }
 
     mMainUi->BufferProgressBar->setValue( fill );
+
+    if( mAudioSrc && mSignalStarted )
+    {
+        showRenderStats( mAudioSrc->getRenderStats() );
+
+        const AudioSource::RingStats stats = mAudioSrc->getRingStats();
+
+        mMainUi->BufferProgressBar->setToolTip( QString( "Render ring: %1% full, minimum %2%, %3 underruns" )
+                                                .arg( 100 * stats.fillLevel / stats.capacity )
+                                                .arg( 100 * stats.minFillLevel / stats.capacity )
+                                                .arg( stats.nrOfUnderruns ) );
+    }
 }
 
 
@@ -4663,32 +4145,35 @@ void Sippora::updateControls()
     /////////////////////////////
     // SignalItemGroupBox
     /////////////////////////////
-    mMainUi->SignalTypesTab->setEnabled( !mSignalUndefined && !mSignalStarted );
+    // while generating, only the edited item can be changed, live
+    mMainUi->SignalTypesTab->setEnabled( !mSignalUndefined && ( !mSignalStarted || mIsSignalEdited ) );
 
-    mMainUi->SignalItemActionButton->setEnabled( !mSignalUndefined && !mSignalStarted );
+    mMainUi->SignalItemActionButton->setEnabled( !mSignalUndefined && ( !mSignalStarted || mIsSignalEdited ) );
     mMainUi->SignalItemActionButton->setText( mIsSignalEdited ? "Replace current signal item" : "Add to active signal" );
 
     /////////////////////////////
     // ActiveSignalGroupBox
     /////////////////////////////
-    mMainUi->ActiveSignalGroupBox->setEnabled( !mSignalUndefined && !mSignalStarted );
+    mMainUi->ActiveSignalGroupBox->setEnabled( !mSignalUndefined );
 
     bool activeSignalBtnCondition = !mSignalUndefined && mSignalsVector.size() && !mIsSignalEdited;
     mMainUi->ActiveSignalEditButton->setEnabled( activeSignalBtnCondition );
-    mMainUi->ActiveSignalSaveButton->setEnabled( activeSignalBtnCondition );
-    mMainUi->ActiveSignalRemoveButton->setEnabled( activeSignalBtnCondition );
+    mMainUi->ActiveSignalSaveButton->setEnabled( activeSignalBtnCondition && !mSignalStarted );
+    mMainUi->ActiveSignalRemoveButton->setEnabled( activeSignalBtnCondition && !mSignalStarted );
 
     mMainUi->ActiveSignalList->setEnabled( !mIsSignalEdited );
 
     /////////////////////////////
     // GenerateGroupBox
     /////////////////////////////
-    mMainUi->GenerateGroupBox->setEnabled( mSignalReady && !mIsSignalEdited );
+    mMainUi->GenerateGroupBox->setEnabled( mSignalReady && ( !mIsSignalEdited || mSignalStarted ) );
+    mMainUi->actionRenderWav->setEnabled( mSignalReady && !mIsSignalEdited );
 
     mMainUi->GeneratePauseButton->setText( mSignalPaused ? "Continue" : "Pause" );
 
-    mMainUi->GenerateDeviceComboBox->setEnabled( !mSignalStarted && !mSignalPaused );
+    mMainUi->GenerateDeviceComboBox->setEnabled( !mSignalPaused );
     mMainUi->BufferLengthSpin->setEnabled( !mSignalStarted && !mSignalPaused );
+    mMainUi->GenerateRealTimeCheckBox->setEnabled( !mSignalStarted && !mSignalPaused );
 
     mMainUi->GenerateStartButton->setEnabled( mSignalReady && !mSignalStarted && !mSignalPaused );
     mMainUi->GeneratePauseButton->setEnabled( mSignalReady && mSignalStarted );
@@ -24,6 +24,7 @@ This file contains the definitions for the signal generator.
 #define Sippora_h
 
 #include <QAudioOutput>
+#include <QLabel>
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QStringListModel>
@@ -35,6 +36,7 @@ This file contains the definitions for the signal generator.
 
 #include "SignalItem.h"
 #include "AudioSource.h"
+#include "RenderStats.h"
 #include "./ui_About.h"
 
 
@@ -65,6 +67,9 @@ class Sippora : public QMainWindow
         const QString SUBSTR_DELIMITER = ", ";                          //!< parameter delimiter in signal
 
         static const int TIMER_PER_MS = 1000;                           //!< timer period [ms]
+        static const int BUFFER_LENGTH_DELAY_MS = 500;                  //!< delay before a changed buffer length is applied [ms]
+
+        static const int AUDIO_SAMPLE_RATE = 44100;                     //!< sample rate of the generated signal [Hz]
 
     //************************************************************************
     // functions
@@ -77,8 +82,17 @@ class Sippora : public QMainWindow
 
         ~Sippora();
 
+        RenderStats getLastRenderStats() const;
+
 
     private:
+        SignalItem createEditedSignalItem() const;
+
+        QString createSignalString
+            (
+            const SignalItem*                   aSignal     //!< a signal item
+            ) const;
+
         QString createSignalStringTriangle
             (
             const SignalItem::SignalTriangle    aSignal     //!< a Triangle signal
@@ -154,15 +168,19 @@ class Sippora : public QMainWindow
             const QAudioDeviceInfo&     aDeviceInfo     //!< audio device
             );
 
+        void publishLiveData();
+
         void setAudioData();
 
+        void showRenderStats
+            (
+            const RenderStats&          aStats          //!< statistics of the last render
+            );
+
         void updateControls();
 
     private slots:
-        void handleAudioBufferLengthChanged
-            (
-            int aValue      //!< value
-            );
+        void handleAudioBufferLengthChanged();
 
         void handleAbout();
 
@@ -181,9 +199,15 @@ class Sippora : public QMainWindow
         void handleGenerateStart();
         void handleGeneratePauseResume();
         void handleGenerateStop();
+        void handleGenerateRealTimeToggled
+            (
+            bool    aChecked    //!< checked state
+            );
+        void handleGenerateStartAtChanged();
 
         void handleSignalNew();
         void handleSignalOpen();
+        void handleSignalRenderWav();
 
 
         void handleSignalChangedTriangleTPeriod();
@@ -280,6 +304,8 @@ class Sippora : public QMainWindow
         void handleSignalChangedNoiseOffset();
 
 
+        void handleSignalParameterEdited();
+
         void handleSignalTypeChanged();
 
         void handleVolumeChanged
@@ -301,6 +327,7 @@ class Sippora : public QMainWindow
 
         bool                            mSignalUndefined;       //!< true if a signal is undefined
         bool                            mSignalReady;           //!< true if a signal is ready
+        bool                            mSignalUnsaved;         //!< true if a ready signal was replaced while generating and not saved since
         bool                            mSignalStarted;         //!< true if a signal is currently generated
         bool                            mSignalPaused;          //!< true if a signal is currently paused
 
@@ -329,10 +356,14 @@ class Sippora : public QMainWindow
         QScopedPointer<AudioSource>     mAudioSrc;              //!< audio source
         QScopedPointer<QAudioOutput>    mAudioOutput;           //!< audio output        
         uint32_t                        mAudioBufferLength;     //!< audio buffer length
+        QTimer*                         mBufferLengthTimer;     //!< debounces changes of the audio buffer length
 
         int                             mAudioBufferProgress;   //!< percentage progress in audio buffer
         QTimer*                         mAudioBufferTimer;      //!< timer for progress in audio buffer
         uint64_t                        mAudioBufferCounter;    //!< counter for the audio buffer
+
+        QLabel*                         mRenderStatsLabel;      //!< render stages of the last render, in the status bar
+        RenderStats                     mLastRenderStats;       //!< render stages of the last render
 };
 
 #endif // Sippora_h
@@ -0,0 +1,423 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SipporaCore.cpp
+This file contains the sources for the C interface of the render engine library.
+*/
+
+#include "SipporaCore.h"
+
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "NoisePwrSpectrum.h"
+#include "PresetFile.h"
+#include "RenderEngine.h"
+#include "RenderStats.h"
+#include "SignalItem.h"
+
+
+static_assert( SIPPORA_CHUNK_ALIGNMENT == RenderEngine::CHUNK_ALIGNMENT, "SIPPORA_CHUNK_ALIGNMENT must match the render engine" );
+static_assert( static_cast<int>( SIPPORA_STAGE_COUNT ) == static_cast<int>( RenderStats::STAGE_COUNT ), "SipporaStage must match RenderStats::Stage" );
+
+
+//************************************************************************
+// Engine behind the opaque handle of the C interface
+//************************************************************************
+struct SipporaEngine
+{
+    RenderEngine                engine;         //!< render engine
+    std::vector<SignalItem>     items;          //!< signal items, in the order they were added
+    std::vector<double>         renderData;     //!< block rendered before quantization
+    RenderStats                 stats;          //!< render stages since the last reset
+
+    SipporaEngine
+        (
+        const uint32_t  aSampleRate,    //!< sample rate [Hz]
+        const uint32_t  aSeed           //!< seed value
+        )
+        : engine( aSampleRate, aSeed )
+    {
+    }
+
+    void applyItems()
+    {
+        std::vector<SignalItem*> signalsVector;
+
+        for( auto& crtItem : items )
+        {
+            signalsVector.push_back( &crtItem );
+        }
+
+        engine.setData( signalsVector );
+    }
+
+    void collectStats()
+    {
+        stats.add( engine.getStats() );
+        engine.resetStats();
+    }
+};
+
+
+//!************************************************************************
+//! Add a signal item to the engine, given as a line of a text preset
+//! The engine rewinds to sample 0.
+//!
+//! @returns: 1 if the line is a valid signal item, 0 otherwise
+//!************************************************************************
+int sippora_engine_add_item
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aLine           //!< line of a text preset
+    )
+{
+    if( !aEngine || !aLine )
+    {
+        return 0;
+    }
+
+    try
+    {
+        std::unique_ptr<SignalItem> crtSignal( PresetFile::parseLine( std::string_view( aLine ) ) );
+
+        if( !crtSignal )
+        {
+            return 0;
+        }
+
+        aEngine->items.push_back( *crtSignal );
+        aEngine->applyItems();
+    }
+    catch( ... )
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+//!************************************************************************
+//! Remove all the signal items of the engine
+//! The engine rewinds to sample 0 and renders silence.
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_engine_clear
+    (
+    SipporaEngine*      aEngine         //!< engine
+    )
+{
+    if( aEngine )
+    {
+        aEngine->items.clear();
+        aEngine->applyItems();
+    }
+}
+
+
+//!************************************************************************
+//! Create an engine without any signal item
+//!
+//! @returns: the engine, or null if it could not be created
+//!************************************************************************
+SipporaEngine* sippora_engine_create
+    (
+    uint32_t            aSampleRate,    //!< sample rate [Hz]
+    uint32_t            aSeed           //!< seed value
+    )
+{
+    if( 0 == aSampleRate )
+    {
+        return nullptr;
+    }
+
+    return new( std::nothrow ) SipporaEngine( aSampleRate, aSeed );
+}
+
+
+//!************************************************************************
+//! Destroy an engine
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_engine_destroy
+    (
+    SipporaEngine*      aEngine         //!< engine, may be null
+    )
+{
+    delete aEngine;
+}
+
+
+//!************************************************************************
+//! Get the number of signal items of the engine
+//!
+//! @returns: number of signal items
+//!************************************************************************
+size_t sippora_engine_get_item_count
+    (
+    const SipporaEngine*    aEngine     //!< engine
+    )
+{
+    return aEngine ? aEngine->items.size() : 0;
+}
+
+
+//!************************************************************************
+//! Get the index of the next rendered sample
+//!
+//! @returns: sample index
+//!************************************************************************
+uint64_t sippora_engine_get_position
+    (
+    const SipporaEngine*    aEngine     //!< engine
+    )
+{
+    return aEngine ? aEngine->engine.getPosition() : 0;
+}
+
+
+//!************************************************************************
+//! Get the time and bytes of each render stage since the engine was
+//! created or sippora_engine_reset_stats() was called
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_engine_get_stats
+    (
+    const SipporaEngine*    aEngine,    //!< engine
+    SipporaRenderStats*     aStats      //!< receives the statistics since the last reset
+    )
+{
+    if( aStats )
+    {
+        for( int s = 0; s < SIPPORA_STAGE_COUNT; s++ )
+        {
+            const RenderStats::StageStats stage = aEngine ? aEngine->stats.getStage( static_cast<RenderStats::Stage>( s ) ) : RenderStats::StageStats{ 0, 0 };
+
+            aStats->nanoseconds[s] = stage.nanoseconds;
+            aStats->bytes[s] = stage.bytes;
+        }
+    }
+}
+
+
+//!************************************************************************
+//! Add the signal items of a text or binary preset file to the engine
+//! The engine rewinds to sample 0. Invalid lines or records are skipped.
+//!
+//! @returns: 1 if the file was read, 0 otherwise
+//!************************************************************************
+int sippora_engine_load_preset
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aFileName       //!< text or binary preset file
+    )
+{
+    if( !aEngine || !aFileName )
+    {
+        return 0;
+    }
+
+    std::vector<SignalItem*> signalsVector;
+    bool status = false;
+
+    try
+    {
+        status = PresetFile::read( aFileName, signalsVector );
+
+        for( const auto& crtSignal : signalsVector )
+        {
+            aEngine->items.push_back( *crtSignal );
+        }
+
+        aEngine->applyItems();
+    }
+    catch( ... )
+    {
+        status = false;
+    }
+
+    for( auto& crtSignal : signalsVector )
+    {
+        delete crtSignal;
+    }
+
+    return status ? 1 : 0;
+}
+
+
+//!************************************************************************
+//! Render the next samples of the signal
+//! aCount must be a multiple of SIPPORA_CHUNK_ALIGNMENT, except for the
+//! last block of a signal.
+//!
+//! @returns: 1 if the samples were rendered, 0 otherwise
+//!************************************************************************
+int sippora_engine_render
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    double*             aData,          //!< output samples
+    size_t              aCount          //!< number of samples
+    )
+{
+    if( !aEngine || ( !aData && aCount ) )
+    {
+        return 0;
+    }
+
+    try
+    {
+        aEngine->engine.render( aData, aCount );
+        aEngine->collectStats();
+    }
+    catch( ... )
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+//!************************************************************************
+//! Render the next samples of the signal as 16 bit samples
+//! aCount must be a multiple of SIPPORA_CHUNK_ALIGNMENT, except for the
+//! last block of a signal.
+//!
+//! @returns: 1 if the samples were rendered, 0 otherwise
+//!************************************************************************
+int sippora_engine_render_int16
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    int16_t*            aSamples,       //!< output 16 bit samples
+    size_t              aCount          //!< number of samples
+    )
+{
+    if( !aEngine || ( !aSamples && aCount ) )
+    {
+        return 0;
+    }
+
+    try
+    {
+        aEngine->renderData.resize( aCount );
+        aEngine->engine.render( aEngine->renderData.data(), aCount );
+        aEngine->collectStats();
+
+        const RenderStats::Clock::time_point t0 = RenderStats::Clock::now();
+        RenderEngine::quantize( aEngine->renderData.data(), aSamples, aCount );
+        aEngine->stats.add( RenderStats::STAGE_QUANTIZATION, RenderStats::getNanosecondsSince( t0 ), aCount * sizeof( int16_t ) );
+    }
+    catch( ... )
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+//!************************************************************************
+//! Render the signal from sample 0 to a 16 bit mono WAV file
+//! The engine rewinds to sample 0 afterwards.
+//!
+//! @returns: 1 if the file was written, 0 otherwise
+//!************************************************************************
+int sippora_engine_render_to_wav
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aFileName,      //!< output file name
+    uint64_t            aNrOfSamples    //!< number of samples
+    )
+{
+    if( !aEngine || !aFileName )
+    {
+        return 0;
+    }
+
+    bool status = false;
+
+    try
+    {
+        status = aEngine->engine.renderToWav( aFileName, aNrOfSamples );
+        aEngine->collectStats();
+        aEngine->engine.reset();
+    }
+    catch( ... )
+    {
+        status = false;
+    }
+
+    return status ? 1 : 0;
+}
+
+
+//!************************************************************************
+//! Clear the statistics of the render stages
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_engine_reset_stats
+    (
+    SipporaEngine*      aEngine         //!< engine
+    )
+{
+    if( aEngine )
+    {
+        aEngine->stats.reset();
+    }
+}
+
+
+//!************************************************************************
+//! Move the engine to a sample of the signal
+//! See RenderEngine::seek().
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_engine_seek
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    uint64_t            aPosition       //!< sample index
+    )
+{
+    if( aEngine )
+    {
+        aEngine->engine.seek( aPosition );
+    }
+}
+
+
+//!************************************************************************
+//! Set the process-wide limit of threads used for filtering one signal
+//! See NoisePwrSpectrum::setMaxThreads().
+//!
+//! @returns: nothing
+//!************************************************************************
+void sippora_set_max_threads
+    (
+    unsigned            aMaxThreads     //!< maximum number of noise filter threads, 0 for the default
+    )
+{
+    NoisePwrSpectrum::setMaxThreads( aMaxThreads );
+}
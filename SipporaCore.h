@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SipporaCore.h
+This file contains the C interface of the render engine library.
+*/
+
+#ifndef SipporaCore_h
+#define SipporaCore_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//************************************************************************
+// C interface of the sippora_core library
+//
+// Lets other programs render signals in-process, without Qt. An engine
+// holds a list of signal items, each given as a line of a text preset
+// (see PresetFile), and renders their superposition from sample 0 on.
+// Rendered blocks must hold a multiple of SIPPORA_CHUNK_ALIGNMENT
+// samples, except the last one.
+//
+//   SipporaEngine* engine = sippora_engine_create( 44100, 0 );
+//   sippora_engine_add_item( engine, "1, 1, 0.5, 0.5, 0, 1, -1" );      // triangle
+//   sippora_engine_add_item( engine, "11, 2, 1, 0, 0.1, 0, 11, 2" );    // noise, 11 filter blocks
+//   sippora_engine_render( engine, buffer, 44100 );
+//   sippora_engine_destroy( engine );
+//
+// The time and bytes of each render stage are accumulated until
+// sippora_engine_reset_stats().
+// Functions returning int return 1 on success and 0 on failure. An
+// engine must not be used by several threads at the same time; distinct
+// engines are independent.
+//************************************************************************
+
+#define SIPPORA_CHUNK_ALIGNMENT 512      //!< RenderEngine::CHUNK_ALIGNMENT
+
+typedef struct SipporaEngine SipporaEngine;
+
+typedef enum
+{
+    SIPPORA_STAGE_SYNTHESIS,            //!< deterministic signal items
+    SIPPORA_STAGE_NOISE_GENERATION,     //!< white noise of the noise items
+    SIPPORA_STAGE_NOISE_FILTERING,      //!< colouring of the noise
+    SIPPORA_STAGE_QUANTIZATION,         //!< conversion to 16 bit samples
+    SIPPORA_STAGE_COPY,                 //!< copy to a file
+
+    SIPPORA_STAGE_COUNT
+}SipporaStage;
+
+typedef struct
+{
+    uint64_t    nanoseconds[SIPPORA_STAGE_COUNT];   //!< time spent in each stage [ns]
+    uint64_t    bytes[SIPPORA_STAGE_COUNT];         //!< bytes produced by each stage
+}SipporaRenderStats;
+
+SipporaEngine* sippora_engine_create
+    (
+    uint32_t            aSampleRate,    //!< sample rate [Hz]
+    uint32_t            aSeed           //!< seed value
+    );
+
+void sippora_engine_destroy
+    (
+    SipporaEngine*      aEngine         //!< engine, may be null
+    );
+
+int sippora_engine_add_item
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aLine           //!< line of a text preset
+    );
+
+void sippora_engine_clear
+    (
+    SipporaEngine*      aEngine         //!< engine
+    );
+
+size_t sippora_engine_get_item_count
+    (
+    const SipporaEngine*    aEngine     //!< engine
+    );
+
+uint64_t sippora_engine_get_position
+    (
+    const SipporaEngine*    aEngine     //!< engine
+    );
+
+void sippora_engine_get_stats
+    (
+    const SipporaEngine*    aEngine,    //!< engine
+    SipporaRenderStats*     aStats      //!< receives the statistics since the last reset
+    );
+
+int sippora_engine_load_preset
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aFileName       //!< text or binary preset file
+    );
+
+int sippora_engine_render
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    double*             aData,          //!< output samples
+    size_t              aCount          //!< number of samples
+    );
+
+int sippora_engine_render_int16
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    int16_t*            aSamples,       //!< output 16 bit samples
+    size_t              aCount          //!< number of samples
+    );
+
+int sippora_engine_render_to_wav
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    const char*         aFileName,      //!< output file name
+    uint64_t            aNrOfSamples    //!< number of samples
+    );
+
+void sippora_engine_reset_stats
+    (
+    SipporaEngine*      aEngine         //!< engine
+    );
+
+void sippora_engine_seek
+    (
+    SipporaEngine*      aEngine,        //!< engine
+    uint64_t            aPosition       //!< sample index
+    );
+
+void sippora_set_max_threads
+    (
+    unsigned            aMaxThreads     //!< maximum number of noise filter threads, 0 for the default
+    );
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SipporaCore_h
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+WavWriter.cpp
+This file contains the sources for the streaming WAV file writer.
+*/
+
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+WavWriter::WavWriter()
+    : mStreamBuffer( new char[BUFFER_SIZE] )
+    , mSampleRate( 0 )
+    , mNrOfChannels( 0 )
+    , mDataSize( 0 )
+{
+}
+
+
+//!************************************************************************
+//! Destructor
+//!************************************************************************
+WavWriter::~WavWriter()
+{
+    close();
+    delete[] mStreamBuffer;
+}
+
+
+//!************************************************************************
+//! Append the samples of another file to the data chunk
+//!
+//! The file must have been written by a WavWriter with the same format,
+//! so that its data starts right after the fixed size header and is
+//! already in little endian byte order. This is used for stitching the
+//! parts of a render which was split between processes.
+//!
+//! @returns: true if all the samples were copied
+//!************************************************************************
+bool WavWriter::append
+    (
+    const std::string&  aFileName       //!< file written by a WavWriter with the same format
+    )
+{
+    std::ifstream inFile( aFileName, std::ios::binary );
+    char magic[4] = {};
+    bool status = mFile.is_open()
+               && inFile.read( magic, sizeof( magic ) )
+               && ( 0 == memcmp( magic, "RIFF", 4 ) || 0 == memcmp( magic, "RF64", 4 ) )
+               && inFile.seekg( HEADER_SIZE );
+
+    std::vector<char> block( BUFFER_SIZE );
+
+    while( status && inFile.read( block.data(), block.size() ).gcount() > 0 )
+    {
+        const size_t count = static_cast<size_t>( inFile.gcount() ) & ~static_cast<size_t>( 1 );
+
+        mFile.write( block.data(), count );
+        mDataSize += count;
+        status = mFile.good();
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Write the final sizes to the header and close the file
+//!
+//! @returns: true if the file was finalized successfully
+//!************************************************************************
+bool WavWriter::close()
+{
+    bool status = false;
+
+    if( mFile.is_open() )
+    {
+        if( mDataSize % 2 )
+        {
+            mFile.put( 0 );     // chunks are word aligned
+        }
+
+        status = writeHeader();
+        mFile.close();
+        status = status && !mFile.fail();
+    }
+
+    return status;
+}
+
+
+//!************************************************************************
+//! Get the number of samples written
+//!
+//! @returns: number of samples (all channels)
+//!************************************************************************
+uint64_t WavWriter::getNrOfSamples() const
+{
+    return mDataSize / ( BITS_PER_SAMPLE / 8 );
+}
+
+
+//!************************************************************************
+//! Create the file and write a provisional header
+//!
+//! @returns: true if the file could be created
+//!************************************************************************
+bool WavWriter::open
+    (
+    const std::string&  aFileName,      //!< file name
+    const uint32_t      aSampleRate,    //!< sample rate [Hz]
+    const uint16_t      aNrOfChannels   //!< number of channels
+    )
+{
+    close();
+
+    mSampleRate = aSampleRate;
+    mNrOfChannels = aNrOfChannels;
+    mDataSize = 0;
+
+    mFile.rdbuf()->pubsetbuf( mStreamBuffer, BUFFER_SIZE );
+    mFile.open( aFileName, std::ios::binary | std::ios::trunc );
+
+    return mFile.is_open() && writeHeader();
+}
+
+
+//!************************************************************************
+//! Store a value in little endian byte order
+//!
+//! @returns: nothing
+//!************************************************************************
+void WavWriter::putLe
+    (
+    char*           aDest,          //!< destination
+    uint64_t        aValue,         //!< value
+    const int       aNrOfBytes      //!< number of bytes
+    )
+{
+    for( int i = 0; i < aNrOfBytes; i++ )
+    {
+        aDest[i] = static_cast<char>( aValue & 0xff );
+        aValue >>= 8;
+    }
+}
+
+
+//!************************************************************************
+//! Append samples to the data chunk
+//!
+//! @returns: true if the samples were written
+//!************************************************************************
+bool WavWriter::write
+    (
+    const int16_t*  aSamples,       //!< interleaved samples
+    const size_t    aCount          //!< number of samples (all channels)
+    )
+{
+    const size_t BLOCK_SAMPLES = 4096;
+    char block[BLOCK_SAMPLES * sizeof( int16_t )];
+
+    for( size_t done = 0; done < aCount && mFile.good(); done += BLOCK_SAMPLES )
+    {
+        const size_t count = std::min( BLOCK_SAMPLES, aCount - done );
+
+        for( size_t i = 0; i < count; i++ )
+        {
+            putLe( block + 2 * i, static_cast<uint16_t>( aSamples[done + i] ), 2 );
+        }
+
+        mFile.write( block, 2 * count );
+        mDataSize += 2 * count;
+    }
+
+    return mFile.good();
+}
+
+
+//!************************************************************************
+//! Write the header with the current sizes at the start of the file
+//!
+//! While the sizes fit 32 bits, a RIFF header is written and the ds64
+//! room is kept as a JUNK chunk, which readers skip. Beyond that the
+//! header becomes RF64, with the 64 bit sizes in the ds64 chunk.
+//!
+//! @returns: true if the header was written
+//!************************************************************************
+bool WavWriter::writeHeader()
+{
+    const uint64_t riffSize = HEADER_SIZE - 8 + mDataSize + ( mDataSize % 2 );
+    const bool isRf64 = ( riffSize > MAX_RIFF_SIZE );
+    const uint16_t blockAlign = mNrOfChannels * BITS_PER_SAMPLE / 8;
+
+    char header[HEADER_SIZE] = {};
+    char* p = header;
+
+    memcpy( p, isRf64 ? "RF64" : "RIFF", 4 );
+    putLe( p + 4, isRf64 ? MAX_RIFF_SIZE : riffSize, 4 );
+    memcpy( p + 8, "WAVE", 4 );
+    p += 12;
+
+    memcpy( p, isRf64 ? "ds64" : "JUNK", 4 );
+    putLe( p + 4, DS64_SIZE, 4 );
+
+    if( isRf64 )
+    {
+        putLe( p + 8, riffSize, 8 );
+        putLe( p + 16, mDataSize, 8 );
+        putLe( p + 24, mDataSize / blockAlign, 8 );     // sample frames
+        putLe( p + 32, 0, 4 );                          // no table entries
+    }
+
+    p += 8 + DS64_SIZE;
+
+    memcpy( p, "fmt ", 4 );
+    putLe( p + 4, 16, 4 );
+    putLe( p + 8, 1, 2 );                               // PCM
+    putLe( p + 10, mNrOfChannels, 2 );
+    putLe( p + 12, mSampleRate, 4 );
+    putLe( p + 16, static_cast<uint64_t>( mSampleRate ) * blockAlign, 4 );
+    putLe( p + 20, blockAlign, 2 );
+    putLe( p + 22, BITS_PER_SAMPLE, 2 );
+    p += 24;
+
+    memcpy( p, "data", 4 );
+    putLe( p + 4, isRf64 ? MAX_RIFF_SIZE : mDataSize, 4 );
+
+    const std::streampos endPos = mFile.tellp();
+
+    mFile.seekp( 0 );
+    mFile.write( header, HEADER_SIZE );
+
+    if( endPos > static_cast<std::streampos>( HEADER_SIZE ) )
+    {
+        mFile.seekp( endPos );
+    }
+
+    return mFile.good();
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2023 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+/*
+WavWriter.h
+This file contains the definitions for the streaming WAV file writer.
+*/
+
+#ifndef WavWriter_h
+#define WavWriter_h
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+
+//************************************************************************
+// Class for writing 16 bit PCM WAV files of any length
+//
+// Samples are appended as they are produced and the sizes are written
+// to the header when the file is closed. The header reserves room for a
+// ds64 chunk, so files whose data exceeds 4 GB are finalized in place
+// as RF64 (EBU Tech 3306) instead of RIFF.
+//************************************************************************
+class WavWriter
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const size_t BUFFER_SIZE = 1 << 20;              //!< size of the stream buffer [bytes]
+
+    private:
+        static const uint32_t HEADER_SIZE = 80;                 //!< RIFF + JUNK/ds64 + fmt + data chunk headers [bytes]
+        static const uint32_t DS64_SIZE = 28;                   //!< size of the ds64 chunk body [bytes]
+        static const uint64_t MAX_RIFF_SIZE = 0xffffffff;       //!< largest size which fits a RIFF size field
+        static const uint16_t BITS_PER_SAMPLE = 16;             //!< sample size [bits]
+
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        WavWriter();
+
+        ~WavWriter();
+
+        bool append
+            (
+            const std::string&  aFileName       //!< file written by a WavWriter with the same format
+            );
+
+        bool close();
+
+        uint64_t getNrOfSamples() const;
+
+        bool open
+            (
+            const std::string&  aFileName,      //!< file name
+            const uint32_t      aSampleRate,    //!< sample rate [Hz]
+            const uint16_t      aNrOfChannels   //!< number of channels
+            );
+
+        bool write
+            (
+            const int16_t*  aSamples,       //!< interleaved samples
+            const size_t    aCount          //!< number of samples (all channels)
+            );
+
+    private:
+        bool writeHeader();
+
+        static void putLe
+            (
+            char*           aDest,          //!< destination
+            uint64_t        aValue,         //!< value
+            const int       aNrOfBytes      //!< number of bytes
+            );
+
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::ofstream       mFile;              //!< output file
+        char*               mStreamBuffer;      //!< buffer of the output stream
+        uint32_t            mSampleRate;        //!< sample rate [Hz]
+        uint16_t            mNrOfChannels;      //!< number of channels
+        uint64_t            mDataSize;          //!< number of data bytes written
+};
+
+#endif // WavWriter_h
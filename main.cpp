@@ -23,10 +23,14 @@ This file contains the main application for the signal generator.
 #include "Sippora.h"
 #include <QApplication>
 
+#include "CommandLine.h"
+
 //!************************************************************************
 //! Main application
+//! With command line options (see CommandLine), the signal is rendered
+//! to a file without creating the GUI.
 //!
-//! @returns: code returned by QApplication exec
+//! @returns: code returned by QApplication exec, or by the command line mode
 //!************************************************************************
 int main
     (
@@ -34,6 +38,11 @@ int main
     char*   argv[]
     )
 {
+    if( CommandLine::isRequested( argc, argv ) )
+    {
+        return CommandLine::run( argc, argv );
+    }
+
     QApplication a( argc, argv );
     Sippora w;
     w.show();